@@ -0,0 +1,38 @@
+#!/bin/sh
+# Compares loading a saved binary IR file (--from-ir) against re-parsing the
+# microC source, averaged over several runs. Runs in a scratch directory so the
+# checked-in output/ files are not touched.
+#
+# Usage: bench/ir_load_bench.sh [input.mc] [runs]
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+BIN="$ROOT/microC_translator"
+INPUT=${1:-$ROOT/tests/test_phase6.mc}
+RUNS=${2:-20}
+
+case "$INPUT" in /*) ;; *) INPUT="$(pwd)/$INPUT" ;; esac
+NAME=$(basename "$INPUT")
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+mkdir -p "$WORK/output"
+cd "$WORK"
+
+now_ns() { date +%s%N; }
+
+"$BIN" --emit-ir "$INPUT" > /dev/null
+cp "output/$NAME.ir" "$WORK/$NAME.ir"
+
+start=$(now_ns)
+i=0; while [ $i -lt "$RUNS" ]; do "$BIN" "$INPUT" > /dev/null; i=$((i + 1)); done
+parse_ns=$(( $(now_ns) - start ))
+
+start=$(now_ns)
+i=0; while [ $i -lt "$RUNS" ]; do "$BIN" --from-ir "$WORK/$NAME.ir" > /dev/null; i=$((i + 1)); done
+load_ns=$(( $(now_ns) - start ))
+
+echo "input:        $NAME ($(wc -c < "$INPUT") bytes source, $(wc -c < "$WORK/$NAME.ir") bytes IR)"
+echo "runs:         $RUNS"
+echo "parse .mc:    $(( parse_ns / RUNS / 1000 )) us/run"
+echo "load .ir:     $(( load_ns / RUNS / 1000 )) us/run"
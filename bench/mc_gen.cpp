@@ -0,0 +1,208 @@
+// Synthetic microC workload generator for the translator benchmarks.
+//
+// Writes a valid microC program to stdout. --shape picks which part of the
+// grammar is stressed and --size scales it:
+//
+//   expr     balanced arithmetic trees with <size> leaves per statement
+//   logic    if conditions chaining <size> comparisons with && and ||
+//   globals  <size> global scalars, each read and written by main
+//   nest     begin/end blocks nested <size> deep (split into chains of 400)
+//   calls    <size> functions, each calling the two before it
+//   arrays   global arrays of <size> elements, filled, copied and summed by loops,
+//            plus one constant-index store per element
+//   mixed    all of the above, each at a fraction of <size>
+//
+// Usage: mc_gen [--shape <name>] [--size <n>] [--seed <n>]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <string>
+
+// Nesting beyond this would overflow the parser stack (YYMAXDEPTH)
+static const int MAX_NEST_CHAIN = 400;
+
+static uint32_t rng_state = 1;
+
+// Deterministic across platforms so that a seed always names the same file
+static uint32_t next_random(uint32_t bound) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state % bound;
+}
+
+static std::string local_name(int i) { return "v" + std::to_string(i); }
+
+// Balanced tree over the locals v0..v<local_count-1> and small constants
+static void emit_expression_tree(std::string& out, int leaves, int local_count) {
+    if (leaves <= 1) {
+        if (next_random(4) == 0) out += std::to_string(1 + next_random(9));
+        else out += local_name(next_random(local_count));
+        return;
+    }
+    static const char* ops[] = {" + ", " - ", " * ", " + "};
+    int left = leaves / 2;
+    out += "(";
+    emit_expression_tree(out, left, local_count);
+    out += ops[next_random(4)];
+    emit_expression_tree(out, leaves - left, local_count);
+    out += ")";
+}
+
+static void emit_condition_chain(std::string& out, int terms, int local_count) {
+    static const char* rel[] = {" < ", " > ", " <= ", " >= ", " == ", " != "};
+    for (int i = 0; i < terms; ++i) {
+        if (i > 0) out += next_random(2) ? " && " : " || ";
+        out += local_name(next_random(local_count)) + rel[next_random(6)] + std::to_string(next_random(100));
+    }
+}
+
+static void emit_locals(std::string& out, int count) {
+    for (int i = 0; i < count; ++i) {
+        out += "    integer " + local_name(i) + ";\n";
+    }
+    for (int i = 0; i < count; ++i) {
+        out += "    " + local_name(i) + " = " + std::to_string(i + 1) + ";\n";
+    }
+}
+
+static void gen_expr(std::string& out, int size) {
+    int statements = 8;
+    out += "integer expr_work(integer seed)\nbegin\n";
+    emit_locals(out, 8);
+    for (int s = 0; s < statements; ++s) {
+        out += "    " + local_name(s % 8) + " = ";
+        emit_expression_tree(out, size, 8);
+        out += ";\n";
+    }
+    out += "    return v0 + seed;\nend\n";
+}
+
+static void gen_logic(std::string& out, int size) {
+    out += "integer logic_work(integer seed)\nbegin\n";
+    emit_locals(out, 8);
+    out += "    integer hits;\n    hits = 0;\n";
+    for (int s = 0; s < 4; ++s) {
+        out += "    if (";
+        emit_condition_chain(out, size, 8);
+        out += ")\n        hits = hits + 1;\n    else\n        hits = hits - 1;\n";
+    }
+    out += "    return hits + seed;\nend\n";
+}
+
+static void gen_globals(std::string& out, int size) {
+    for (int i = 0; i < size; ++i) {
+        out += "integer g" + std::to_string(i) + ";\n";
+    }
+    out += "integer globals_work()\nbegin\n";
+    for (int i = 0; i < size; ++i) {
+        out += "    g" + std::to_string(i) + " = " + std::to_string(i) + ";\n";
+    }
+    out += "    integer total;\n    total = 0;\n";
+    for (int i = 0; i < size; ++i) {
+        out += "    total = total + g" + std::to_string(i) + ";\n";
+    }
+    out += "    return total;\nend\n";
+}
+
+static void gen_nest(std::string& out, int size) {
+    out += "integer nest_work(integer seed)\nbegin\n    integer depth;\n    depth = seed;\n";
+    for (int remaining = size; remaining > 0; remaining -= MAX_NEST_CHAIN) {
+        int chain = remaining < MAX_NEST_CHAIN ? remaining : MAX_NEST_CHAIN;
+        std::string indent = "    ";
+        for (int d = 0; d < chain; ++d) {
+            out += indent + "begin\n";
+            out += indent + "    integer n" + std::to_string(d) + ";\n";
+            out += indent + "    n" + std::to_string(d) + " = depth + " + std::to_string(d) + ";\n";
+            out += indent + "    if (n" + std::to_string(d) + " > 0) depth = depth + 1;\n";
+            if (indent.size() < 64) indent += "    ";
+        }
+        for (int d = 0; d < chain; ++d) out += "    end\n";
+    }
+    out += "    return depth;\nend\n";
+}
+
+static void gen_calls(std::string& out, int size) {
+    for (int f = 0; f < size; ++f) {
+        std::string name = "fn" + std::to_string(f);
+        out += "integer " + name + "(integer a, integer b)\nbegin\n    integer r;\n    r = a * " +
+               std::to_string(f % 7 + 1) + " + b;\n";
+        if (f >= 2) {
+            out += "    if (r > " + std::to_string(f * 3) + ") r = fn" + std::to_string(f - 1) + "(r, a) - fn" +
+                   std::to_string(f - 2) + "(b, 1);\n";
+        }
+        out += "    return r;\nend\n";
+    }
+    out += "integer calls_work(integer seed)\nbegin\n    integer acc;\n    acc = 0;\n";
+    for (int f = 0; f < size; f += 1 + size / 64) {
+        out += "    acc = acc + fn" + std::to_string(f) + "(seed, " + std::to_string(f) + ");\n";
+    }
+    out += "    return acc;\nend\n";
+}
+
+static void gen_arrays(std::string& out, int size) {
+    std::string n = std::to_string(size);
+    out += "integer src[" + n + "];\ninteger dst[" + n + "];\nfloat weights[" + n + "];\n";
+    out += "integer arrays_work(integer seed)\nbegin\n    integer i;\n    integer sum;\n    float fsum;\n";
+    out += "    for (i = 0; i < " + n + "; i = i + 1) src[i] = seed + i;\n";
+    out += "    for (i = 0; i < " + n + "; i = i + 1) dst[i] = src[i];\n";
+    out += "    for (i = 0; i < " + n + "; i = i + 1) weights[i] = 0.5;\n";
+    for (int k = 0; k < size; ++k) {
+        out += "    src[" + std::to_string(k) + "] = dst[" + std::to_string(size - 1 - k) + "] + " + std::to_string(k) + ";\n";
+    }
+    out += "    sum = 0;\n    fsum = 0.0;\n";
+    out += "    for (i = 0; i < " + n + "; i = i + 1)\n    begin\n"
+           "        sum = sum + dst[i] * 2;\n        fsum = fsum + weights[i];\n    end\n";
+    out += "    return sum;\nend\n";
+}
+
+static void gen_main(std::string& out, const std::string& shape) {
+    out += "integer main()\nbegin\n    integer result;\n    result = 0;\n";
+    bool all = shape == "mixed";
+    if (all || shape == "expr") out += "    result = result + expr_work(3);\n";
+    if (all || shape == "logic") out += "    result = result + logic_work(5);\n";
+    if (all || shape == "globals") out += "    result = result + globals_work();\n";
+    if (all || shape == "nest") out += "    result = result + nest_work(1);\n";
+    if (all || shape == "calls") out += "    result = result + calls_work(2);\n";
+    if (all || shape == "arrays") out += "    result = result + arrays_work(4);\n";
+    out += "    return result;\nend\n";
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [--shape expr|logic|globals|nest|calls|arrays|mixed] [--size <n>] [--seed <n>]\n", prog);
+}
+
+int main(int argc, char** argv) {
+    std::string shape = "mixed";
+    int size = 100;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--shape") == 0 && i + 1 < argc) shape = argv[++i];
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) size = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) rng_state = (uint32_t)strtoul(argv[++i], nullptr, 10) | 1;
+        else { usage(argv[0]); return 1; }
+    }
+    if (size < 1) { fprintf(stderr, "Error: --size must be positive\n"); return 1; }
+
+    std::string out = "// Generated by mc_gen --shape " + shape + " --size " + std::to_string(size) + "\n";
+    if (shape == "expr") gen_expr(out, size);
+    else if (shape == "logic") gen_logic(out, size);
+    else if (shape == "globals") gen_globals(out, size);
+    else if (shape == "nest") gen_nest(out, size);
+    else if (shape == "calls") gen_calls(out, size);
+    else if (shape == "arrays") gen_arrays(out, size);
+    else if (shape == "mixed") {
+        int part = size / 4 > 0 ? size / 4 : 1;
+        gen_expr(out, part);
+        gen_logic(out, part);
+        gen_globals(out, part);
+        gen_nest(out, part);
+        gen_calls(out, part);
+        gen_arrays(out, size);
+    } else { usage(argv[0]); return 1; }
+    gen_main(out, shape);
+
+    fwrite(out.data(), 1, out.size(), stdout);
+    return 0;
+}
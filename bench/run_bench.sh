@@ -0,0 +1,53 @@
+#!/bin/sh
+# Runs the translator with --stats over generated workloads (bench/mc_gen.cpp)
+# of every shape and size, and records per-phase time, throughput and peak
+# memory per stage as one CSV row per run. Runs in a scratch directory so the
+# checked-in output/ files are not touched.
+#
+# Usage: bench/run_bench.sh [csv_file]
+#   SHAPES="expr logic ..."  shapes to sweep (default: all)
+#   SIZES="100 1000 ..."     sizes to sweep (default: 100 1000 10000)
+#   BIN=..., GEN=...         translator and generator binaries to use
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+BIN=${BIN:-$ROOT/microC_translator}
+GEN=${GEN:-$ROOT/build/mc_gen}
+CSV=${1:-$ROOT/build/bench.csv}
+SHAPES=${SHAPES:-"expr logic globals nest calls arrays mixed"}
+SIZES=${SIZES:-"100 1000 10000"}
+
+case "$CSV" in /*) ;; *) CSV="$(pwd)/$CSV" ;; esac
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+mkdir -p "$WORK/output" "$(dirname "$CSV")"
+cd "$WORK"
+
+# Value of a "key": number line in the stats report
+field() { sed -n "s/^ *\"$2\": \([0-9.]*\),\{0,1\}\$/\1/p" "$1" | head -n 1; }
+# Value of a stage in the one-line "peak_rss_kb_by_stage" object
+stage_rss() { grep '"peak_rss_kb_by_stage"' "$1" | sed -n "s/.*\"$2\": \([0-9]*\).*/\1/p"; }
+
+echo "shape,size,source_bytes,tokens,quads,total_ms,lex_ms,parse_ms,backpatch_ms,typecheck_ms,symbol_table_ms,output_ms,tokens_per_sec,quads_per_sec,rss_parse_kb,rss_symbol_table_kb,rss_output_kb" > "$CSV"
+printf "%-8s %7s %10s %10s %10s %12s %12s %10s\n" shape size tokens quads total_ms tokens/s quads/s peak_kb
+
+for shape in $SHAPES; do
+    for size in $SIZES; do
+        name="${shape}_${size}.mc"
+        "$GEN" --shape "$shape" --size "$size" > "$name"
+        "$BIN" --stats "$name" > /dev/null
+        report="output/$name.stats.json"
+
+        total=$(field "$report" total)
+        tokens=$(field "$report" tokens)
+        quads=$(field "$report" quads)
+        tps=$(field "$report" tokens_per_sec)
+        qps=$(field "$report" quads_per_sec)
+        echo "$shape,$size,$(wc -c < "$name"),$tokens,$quads,$total,$(field "$report" lex),$(field "$report" parse),$(field "$report" backpatch),$(field "$report" typecheck),$(field "$report" symbol_table),$(field "$report" output),$tps,$qps,$(stage_rss "$report" parse),$(stage_rss "$report" symbol_table),$(stage_rss "$report" output)" >> "$CSV"
+        printf "%-8s %7s %10s %10s %10s %12.0f %12.0f %10s\n" "$shape" "$size" "$tokens" "$quads" "$total" "$tps" "$qps" "$(field "$report" peak_rss_kb)"
+        rm -f "$name" output/*
+    done
+done
+
+echo "Results written to $CSV"
@@ -4,6 +4,8 @@
 #include <fstream> // For file output
 #include <string>  // For filename manipulation
 #include <libgen.h> // Required for basename()
+#include <set>
+#include <algorithm>
 
 // --- Define Global Variables ---
 std::vector<Quad> quad_list;
@@ -74,6 +76,24 @@ void apply_pending_types(TypeInfo* base_type) {
         sym->type = final_type;
         sym->size = final_type ? final_type->width : 0; // Update size
 
+        // The initializer was emitted before the declared type was known: type it now,
+        // turning it into the int/float conversion the assignment needs (in place)
+        if (sym->init_quad >= quad_base && sym->init_quad < quad_base + (int)quad_list.size()) {
+            Quad& init = quad_list[sym->init_quad - quad_base];
+            Symbol* source = lookup_symbol(init.arg1);
+            operand_class target_class = class_of(sym->type);
+            operand_class source_class = source ? class_of(source->type) : CLASS_NONE;
+            init.type_class = target_class;
+            if (target_class == CLASS_F64 && (source_class == CLASS_I8 || source_class == CLASS_I32)) {
+                init.op = OP_INT2FLOAT;
+                init.type_class = source_class;
+            } else if ((target_class == CLASS_I8 || target_class == CLASS_I32) && source_class == CLASS_F64) {
+                init.op = OP_FLOAT2INT;
+                init.type_class = source_class;
+            }
+        }
+        sym->init_quad = -1;
+
         if (sym->type) {
             std::cout << "Debug: Applied final type '" << sym->type->toString()
                       << "' to pending symbol '" << sym->name << "'" << std::endl;
@@ -162,6 +182,8 @@ std::string opcode_to_string(op_code op) {
         case OP_ARRAY_ACCESS: return "[]"; case OP_ARRAY_ASSIGN: return "[]=";
         case OP_INT2FLOAT: return "int2float"; case OP_FLOAT2INT: return "float2int";
         case OP_FUNC_BEGIN: return "func_begin"; case OP_FUNC_END: return "func_end";
+        case OP_BLOCK_FILL: return "block_fill"; case OP_BLOCK_COPY: return "block_copy";
+        case OP_TAILCALL: return "tailcall";
         // --- Phase 4: Add strings for new opcodes ---
         case OP_IF_LT: return "if<"; case OP_IF_GT: return "if>";
         case OP_IF_LE: return "if<="; case OP_IF_GE: return "if>=";
@@ -172,19 +194,49 @@ std::string opcode_to_string(op_code op) {
 }
 
 
+operand_class class_of(const TypeInfo* type) {
+    if (!type) return CLASS_NONE;
+    switch (type->base) {
+        case TYPE_CHAR: return CLASS_I8;
+        case TYPE_INTEGER: return CLASS_I32;
+        case TYPE_FLOAT: return CLASS_F64;
+        case TYPE_POINTER: case TYPE_ARRAY: return CLASS_PTR; // Arrays are passed by address
+        default: return CLASS_NONE;
+    }
+}
+
+std::string class_suffix(operand_class type_class) {
+    switch (type_class) {
+        case CLASS_I8: return ".i8"; case CLASS_I16: return ".i16"; case CLASS_I32: return ".i32";
+        case CLASS_F64: return ".f64"; case CLASS_PTR: return ".ptr";
+        default: return "";
+    }
+}
+
+int class_size(operand_class type_class) {
+    switch (type_class) {
+        case CLASS_I8: return 1; case CLASS_I16: return 2; case CLASS_I32: return 4;
+        case CLASS_F64: case CLASS_PTR: return 8;
+        default: return 0;
+    }
+}
+
+
+// Typed quads print their class after the operator, e.g. "t2 = a +.i32 b"
 std::string Quad::toString() const {
-    std::string op_str = opcode_to_string(op);
+    std::string sfx = class_suffix(type_class);
+    std::string op_str = opcode_to_string(op) + sfx;
     std::string res_str = result; // Usually target for jumps
     std::string a1_str = arg1;
     std::string a2_str = arg2;
 
     // Regular binary/unary assignments (including conversions)
     if (op == OP_ASSIGN){
-        return res_str + " = " + a1_str; // Assignment
+        return res_str + " =" + sfx + " " + a1_str; // Assignment
     }
     // --- Adjusted OP_ASSIGN_DEREF handling ---
     if (op == OP_ASSIGN_DEREF) { // e.g., t = *p
-        return res_str + " = * " + a1_str;
+        return res_str + " =" + sfx + " * " + a1_str;
     }    
     if ((op >= OP_PLUS && op <= OP_MOD) || (op >= OP_LT && op <= OP_NE) || (op == OP_AND) || (op == OP_OR) ||
         (op == OP_UMINUS) || (op == OP_UPLUS) || (op == OP_NOT) || (op == OP_ADDR) || (op == OP_INT2FLOAT) || (op == OP_FLOAT2INT) )
@@ -214,15 +266,19 @@ std::string Quad::toString() const {
     // Function related
     else if (op == OP_PARAM) { return op_str + " " + res_str; }
     else if (op == OP_CALL) { return (res_str.empty() ? "" : res_str + " = ") + op_str + " " + a1_str + ", " + a2_str; }
+    else if (op == OP_TAILCALL) { return op_str + " " + a1_str + ", " + a2_str; }
     else if (op == OP_RETURN) { return op_str + (res_str.empty() ? "" : " " + res_str); }
     else if (op == OP_FUNC_BEGIN || op == OP_FUNC_END) { return op_str + " " + res_str; }
     // Pointer/Array
     else if (op == OP_DEREF_ASSIGN) { // e.g., *p = t
-        return "* " + res_str + " = " + a1_str;
+        return "* " + res_str + " =" + sfx + " " + a1_str;
     }
-    else if (op == OP_ARRAY_ACCESS) { return res_str + " = " + a1_str + "[" + a2_str + "]"; }
+    else if (op == OP_ARRAY_ACCESS) { return res_str + " =" + sfx + " " + a1_str + "[" + a2_str + "]"; }
     else if (op == OP_ARRAY_ASSIGN) {
-        return res_str + "[" + a1_str + "] = " + a2_str;
+        return res_str + "[" + a1_str + "] =" + sfx + " " + a2_str;
+    }
+    else if (op == OP_BLOCK_FILL || op == OP_BLOCK_COPY) { // e.g., block_fill.i32 a, 0, 40 (40 bytes)
+        return op_str + " " + res_str + ", " + a1_str + ", " + a2_str;
     }
 
     // Fallback (shouldn't normally be reached if all ops handled)
@@ -233,123 +289,284 @@ std::string Quad::toString() const {
 
 // --- Translator Function Implementations ---
 
-void emit(op_code op, std::string result, std::string arg1, std::string arg2) {
-    quad_list.emplace_back(op, result, arg1, arg2);
+void emit(op_code op, std::string result, std::string arg1, std::string arg2, operand_class type_class) {
+    if (stats_enabled) stats_count_quad(op);
+    quad_list.emplace_back(op, result, arg1, arg2, type_class);
     next_quad_index++;
 }
 
+// --- Output Formatting ---
+// Lines are formatted into a std::string and written in large chunks; the layout
+// matches the original std::setw/std::left output byte for byte.
+static const size_t OUTPUT_CHUNK_SIZE = 1 << 16;
+
+struct OutputBuffer {
+    std::ofstream file;
+    std::string buf;
+
+    void flush() {
+        if (!buf.empty()) { file.write(buf.data(), buf.size()); buf.clear(); }
+    }
+    void flush_if_full() {
+        if (buf.size() >= OUTPUT_CHUNK_SIZE) flush();
+    }
+};
+
+static void append_padded(std::string& out, const std::string& s, size_t width) {
+    out += s;
+    if (s.size() < width) out.append(width - s.size(), ' ');
+}
+
+static const char* TAC_HEADER = "\n--- Generated Three Address Code ---\n";
+static const char* TAC_EMPTY = "(No TAC generated)\n";
+static const char* TAC_FOOTER = "------------------------------------\n";
+
+static void append_quad_header(std::string& out) {
+    append_padded(out, "Op", 15);
+    append_padded(out, "Arg1", 15);
+    append_padded(out, "Arg2", 15);
+    append_padded(out, "Result", 15);
+    out += '\n';
+    out.append(60, '-');
+    out += '\n';
+}
+
+void format_tac_line(std::string& out, int index, const Quad& quad) {
+    append_padded(out, std::to_string(index), 4);
+    out += ": ";
+    out += quad.toString();
+    out += '\n';
+}
+
+void format_quad_line(std::string& out, const Quad& quad) {
+    std::string op_str = opcode_to_string(quad.op);
+    std::string res_str = quad.result;
+    std::string a1_str = quad.arg1;
+    std::string a2_str = quad.arg2;
+
+    // Adjust fields based on operation for standard quad format
+    switch (quad.op) {
+        case OP_GOTO:
+            a1_str = ""; a2_str = ""; // Target is in result
+            break;
+        case OP_IF_FALSE:
+        case OP_IF_TRUE:
+             // op arg1 goto result -> op=op, arg1=arg1, arg2="", result=result
+             a2_str = "";
+             break;
+        case OP_IF_LT: case OP_IF_GT: case OP_IF_LE: case OP_IF_GE: case OP_IF_EQ: case OP_IF_NE:
+             // if arg1 OP arg2 goto result -> op=op, arg1=arg1, arg2=arg2, result=result
+             break; // Fields are already correct
+        case OP_ASSIGN:
+             // result = arg1 -> op=op, arg1=arg1, arg2="", result=result
+             a2_str = "";
+             break;
+        case OP_UMINUS: case OP_UPLUS: case OP_NOT: case OP_ADDR:
+             // result = op arg1 -> op=op, arg1=arg1, arg2="", result=result
+             a2_str = "";
+             break;
+        case OP_INT2FLOAT: case OP_FLOAT2INT:
+             // result = op arg1 -> op=op, arg1=arg1, arg2="", result=result
+             a2_str = "";
+             break;
+        case OP_PARAM:
+             // param result -> op=op, arg1="", arg2="", result=result
+             a1_str = ""; a2_str = "";
+             break;
+        case OP_CALL:
+             // result = call arg1, arg2 -> op=op, arg1=arg1, arg2=arg2, result=result (arg2 is count)
+             break; // Fields are okay
+        case OP_TAILCALL:
+             // tailcall arg1, arg2 -> op=op, arg1=function, arg2=count, result=""
+             break; // Fields are okay
+        case OP_RETURN:
+             // return result -> op=op, arg1="", arg2="", result=result
+             a1_str = ""; a2_str = "";
+             break;
+        case OP_FUNC_BEGIN: case OP_FUNC_END:
+             // op result -> op=op, arg1="", arg2="", result=result (func name)
+             a1_str = ""; a2_str = "";
+             break;
+        case OP_DEREF_ASSIGN: // *result = arg1
+             op_str = "*="; // Use a distinct op string if needed
+             a2_str = ""; // arg1 is source, result is target address
+             break;
+        case OP_ASSIGN_DEREF: // result = *arg1
+             op_str = "=*"; // Use a distinct op string if needed
+             a2_str = ""; // arg1 is source address, result is target
+             break;
+        case OP_ARRAY_ACCESS: // result = arg1[arg2]
+             op_str = "=[]"; // Use a distinct op string
+             // arg1=base, arg2=offset, result=target
+             break; // Fields are okay
+        case OP_ARRAY_ASSIGN: // result[arg1] = arg2
+             op_str = "[]="; // Use a distinct op string
+             // arg1=offset, arg2=source, result=base
+             break; // Fields are okay
+        case OP_BLOCK_FILL: case OP_BLOCK_COPY:
+             // result = destination array, arg1 = fill value or source array, arg2 = byte count
+             break; // Fields are okay
+
+        // Binary ops (default case handles them)
+        // case OP_PLUS: case OP_MINUS: case OP_MULT: case OP_DIV: case OP_MOD:
+        // case OP_LT: case OP_GT: case OP_LE: case OP_GE: case OP_EQ: case OP_NE:
+        // case OP_AND: case OP_OR:
+        // result = arg1 op arg2 -> op=op, arg1=arg1, arg2=arg2, result=result
+        default:
+             break; // Assume fields are correct for binary ops
+    }
+
+    append_padded(out, op_str + class_suffix(quad.type_class), 15);
+    append_padded(out, a1_str, 15);
+    append_padded(out, a2_str, 15);
+    append_padded(out, res_str, 15);
+    out += '\n';
+}
+
 // New function to print Three-Address Code (existing behavior)
 void print_tac(const std::string& filename) {
-    std::ofstream quad_file(filename);
+    PhaseTimer timer(PHASE_OUTPUT);
+    OutputBuffer out;
+    out.file.open(filename);
 
-    quad_file << "\n--- Generated Three Address Code ---" << std::endl;
+    out.buf += TAC_HEADER;
     if (quad_list.empty()) {
-        quad_file << "(No TAC generated)" << std::endl;
+        out.buf += TAC_EMPTY;
+        out.flush();
         return;
     }
-    quad_file << std::left; // Left-align output
     for (size_t i = 0; i < quad_list.size(); ++i) {
-        quad_file << std::setw(4) << i << ": " << quad_list[i].toString() << std::endl;
+        format_tac_line(out.buf, quad_base + i, quad_list[i]);
+        out.flush_if_full();
     }
-    quad_file << "------------------------------------" << std::endl;
+    out.buf += TAC_FOOTER;
+    out.flush();
 }
 
 // Modified function to print Quads to a file
 void print_quads(const std::string& filename) {
-    std::ofstream quad_file(filename);
-    if (!quad_file.is_open()) {
+    PhaseTimer timer(PHASE_OUTPUT);
+    OutputBuffer out;
+    out.file.open(filename);
+    if (!out.file.is_open()) {
         std::cerr << "Error: Could not open quad output file: " << filename << std::endl;
         return;
     }
 
-    quad_file << std::left; // Left-align output
-    quad_file << std::setw(15) << "Op"
-              << std::setw(15) << "Arg1"
-              << std::setw(15) << "Arg2"
-              << std::setw(15) << "Result" << std::endl;
-    quad_file << std::string(60, '-') << std::endl;
+    append_quad_header(out.buf);
+    for (const auto& quad : quad_list) {
+        format_quad_line(out.buf, quad);
+        out.flush_if_full();
+    }
+    out.flush();
 
+    out.file.close();
+    std::cout << "Quadruple code written to " << filename << std::endl;
+}
 
-    for (const auto& quad : quad_list) {
-        std::string op_str = opcode_to_string(quad.op);
-        std::string res_str = quad.result;
-        std::string a1_str = quad.arg1;
-        std::string a2_str = quad.arg2;
-
-        // Adjust fields based on operation for standard quad format
-        switch (quad.op) {
-            case OP_GOTO:
-                a1_str = ""; a2_str = ""; // Target is in result
-                break;
-            case OP_IF_FALSE:
-            case OP_IF_TRUE:
-                 // op arg1 goto result -> op=op, arg1=arg1, arg2="", result=result
-                 a2_str = "";
-                 break;
-            case OP_IF_LT: case OP_IF_GT: case OP_IF_LE: case OP_IF_GE: case OP_IF_EQ: case OP_IF_NE:
-                 // if arg1 OP arg2 goto result -> op=op, arg1=arg1, arg2=arg2, result=result
-                 break; // Fields are already correct
-            case OP_ASSIGN:
-                 // result = arg1 -> op=op, arg1=arg1, arg2="", result=result
-                 a2_str = "";
-                 break;
-            case OP_UMINUS: case OP_UPLUS: case OP_NOT: case OP_ADDR:
-                 // result = op arg1 -> op=op, arg1=arg1, arg2="", result=result
-                 a2_str = "";
-                 break;
-            case OP_INT2FLOAT: case OP_FLOAT2INT:
-                 // result = op arg1 -> op=op, arg1=arg1, arg2="", result=result
-                 a2_str = "";
-                 break;
-            case OP_PARAM:
-                 // param result -> op=op, arg1="", arg2="", result=result
-                 a1_str = ""; a2_str = "";
-                 break;
-            case OP_CALL:
-                 // result = call arg1, arg2 -> op=op, arg1=arg1, arg2=arg2, result=result (arg2 is count)
-                 break; // Fields are okay
-            case OP_RETURN:
-                 // return result -> op=op, arg1="", arg2="", result=result
-                 a1_str = ""; a2_str = "";
-                 break;
-            case OP_FUNC_BEGIN: case OP_FUNC_END:
-                 // op result -> op=op, arg1="", arg2="", result=result (func name)
-                 a1_str = ""; a2_str = "";
-                 break;
-            case OP_DEREF_ASSIGN: // *result = arg1
-                 op_str = "*="; // Use a distinct op string if needed
-                 a2_str = ""; // arg1 is source, result is target address
-                 break;
-            case OP_ASSIGN_DEREF: // result = *arg1
-                 op_str = "=*"; // Use a distinct op string if needed
-                 a2_str = ""; // arg1 is source address, result is target
-                 break;
-            case OP_ARRAY_ACCESS: // result = arg1[arg2]
-                 op_str = "=[]"; // Use a distinct op string
-                 // arg1=base, arg2=offset, result=target
-                 break; // Fields are okay
-            case OP_ARRAY_ASSIGN: // result[arg1] = arg2
-                 op_str = "[]="; // Use a distinct op string
-                 // arg1=offset, arg2=source, result=base
-                 break; // Fields are okay
-
-            // Binary ops (default case handles them)
-            // case OP_PLUS: case OP_MINUS: case OP_MULT: case OP_DIV: case OP_MOD:
-            // case OP_LT: case OP_GT: case OP_LE: case OP_GE: case OP_EQ: case OP_NE:
-            // case OP_AND: case OP_OR:
-            // result = arg1 op arg2 -> op=op, arg1=arg1, arg2=arg2, result=result
-            default:
-                 break; // Assume fields are correct for binary ops
+// --- Streaming Output ---
+// In streaming mode each function's quads are written out and dropped as soon as
+// its function_definition is reduced, and its scope tree is freed with them.
+// Quad indices stay absolute: quad_base records how many quads were dropped.
+bool streaming_mode = false;
+int quad_base = 0;
+static OutputBuffer stream_tac;
+static OutputBuffer stream_quad;
+static std::string stream_quad_filename;
+
+void begin_streaming_output(const std::string& tac_filename, const std::string& quad_filename) {
+    stream_tac.file.open(tac_filename);
+    stream_quad.file.open(quad_filename);
+    if (!stream_quad.file.is_open()) {
+        std::cerr << "Error: Could not open quad output file: " << quad_filename << std::endl;
+    }
+    stream_quad_filename = quad_filename;
+    stream_tac.buf += TAC_HEADER;
+    append_quad_header(stream_quad.buf);
+}
+
+// Writes every pending quad (the function just reduced plus any global
+// initializers emitted before it) and drops them from quad_list.
+static void flush_pending_quads() {
+    PhaseTimer timer(PHASE_OUTPUT);
+    if (emit_ir_mode) ir_record_quads(quad_list, quad_base);
+    for (size_t i = 0; i < quad_list.size(); ++i) {
+        format_tac_line(stream_tac.buf, quad_base + i, quad_list[i]);
+        format_quad_line(stream_quad.buf, quad_list[i]);
+        stream_tac.flush_if_full();
+        stream_quad.flush_if_full();
+    }
+    quad_base += quad_list.size();
+    quad_list.clear(); // Capacity is kept, so it only grows to the largest function
+}
+
+SymbolTable* find_function_scope(const std::string& func_name) {
+    if (!global_symbol_table) return nullptr;
+    for (auto it = global_symbol_table->child_scopes.rbegin(); it != global_symbol_table->child_scopes.rend(); ++it) {
+        if ((*it)->scope_name == func_name) return *it;
+    }
+    return nullptr;
+}
+
+static void collect_scope_tree(SymbolTable* table, std::vector<SymbolTable*>& tables) {
+    tables.push_back(table);
+    for (SymbolTable* child : table->child_scopes) collect_scope_tree(child, tables);
+}
+
+// Frees a finished scope and everything nested in it. Every symbol in a function
+// scope owns its TypeInfo, but some temporaries share one (e.g. the size constant
+// and offset of an array access), so types are de-duplicated before deletion.
+void release_scope(SymbolTable* scope) {
+    if (!scope || scope == global_symbol_table) return;
+
+    std::vector<SymbolTable*> tables;
+    collect_scope_tree(scope, tables);
+
+    std::set<TypeInfo*> dead_types;
+    for (SymbolTable* table : tables) {
+        for (const auto& [name, symbol] : table->symbols) {
+            if (!symbol) continue;
+            if (symbol->type) dead_types.insert(symbol->type);
+            delete symbol;
         }
+        table->symbols.clear(); // Symbols are gone; keep ~SymbolTable from touching them
+    }
+    if (scope->parent) {
+        auto& siblings = scope->parent->child_scopes;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), scope), siblings.end());
+    }
+    for (TypeInfo* type : dead_types) delete type;
+    for (SymbolTable* table : tables) delete table;
+}
+
+// Called once a function_definition has been reduced and its FUNC_END emitted.
+void finalize_function(Symbol* func_sym) {
+    if (!func_sym) return;
+    if (cache_enabled()) cache_store_function(func_sym);
+    if (!streaming_mode) return;
 
-        quad_file << std::setw(15) << op_str
-                  << std::setw(15) << a1_str
-                  << std::setw(15) << a2_str
-                  << std::setw(15) << res_str << std::endl;
+    flush_pending_quads();
+
+    SymbolTable* scope = find_function_scope(func_sym->name);
+    if (scope) {
+        print_symbol_table(scope, 1);
+        stats_record_scope_tree(scope); // Sizes are lost once the scope is released
+        if (emit_ir_mode) ir_record_function_scope(scope, func_sym, true);
+        release_scope(scope);
+        func_sym->parameters.clear(); // Parameter symbols lived in the released scope
     }
+}
 
-    quad_file.close();
-    std::cout << "Quadruple code written to " << filename << std::endl;
+void end_streaming_output() {
+    PhaseTimer timer(PHASE_OUTPUT);
+    bool any_quads = quad_base > 0 || !quad_list.empty();
+    flush_pending_quads();
+    stream_tac.buf += any_quads ? TAC_FOOTER : TAC_EMPTY;
+    stream_tac.flush();
+    stream_quad.flush();
+    stream_tac.file.close();
+    stream_quad.file.close();
+    std::cout << "Quadruple code written to " << stream_quad_filename << std::endl;
 }
 
 
@@ -397,7 +614,7 @@ Symbol* insert_symbol(const std::string& name, TypeInfo* type) {
             case TYPE_CHAR: sym->size = 1; break;
             case TYPE_BOOL: sym->size = 1; break;
             case TYPE_INTEGER: sym->size = 4; break; // Assuming 4-byte int
-            case TYPE_FLOAT: sym->size = 4; break;   // Assuming 4-byte float
+            case TYPE_FLOAT: sym->size = 8; break;   // A9 spec: 8-byte float
             default: sym->size = 0; // Pointers, arrays, void, functions need calculation
         }
     }
@@ -451,6 +668,7 @@ Symbol* new_temp(TypeInfo* type) {
         // In a real compiler, might try a default type or throw an exception
         type = new TypeInfo(TYPE_UNKNOWN); // Create a fallback unknown type
     }
+    if (stats_enabled) stats_count_temp();
     std::string temp_name = "t" + std::to_string(temp_counter++);
     // Important: Create a *copy* of the type for the temporary if the passed type
     // might be deleted later (e.g., if it came from typecheck). If the type
@@ -466,6 +684,7 @@ Symbol* new_temp(TypeInfo* type) {
 }
 
 TypeInfo* typecheck(TypeInfo* t1, TypeInfo* t2, op_code op) {
+    PhaseTimer timer(PHASE_TYPECHECK);
     if (!t1) return nullptr; // First operand must exist for most ops
 
     // --- Phase 3: Updated numeric checks to include CHAR ---
@@ -592,9 +811,9 @@ Symbol* convert_type(Symbol* s, TypeInfo* target_type) {
 
     if (current_type->base == TYPE_INTEGER && target_type->base == TYPE_FLOAT) {
         std::cout << "Debug: Converting " << s->name << " from integer to float." << std::endl;
-        TypeInfo* float_type = new TypeInfo(TYPE_FLOAT, 4); // Create the target type instance
+        TypeInfo* float_type = new TypeInfo(TYPE_FLOAT, 8); // Create the target type instance (A9 spec)
         Symbol* temp = new_temp(float_type); // Create temp with the correct type
-        emit(OP_INT2FLOAT, temp->name, s->name);
+        emit(OP_INT2FLOAT, temp->name, s->name, "", CLASS_I32);
         return temp;
     }
 
@@ -602,7 +821,7 @@ Symbol* convert_type(Symbol* s, TypeInfo* target_type) {
         std::cout << "Debug: Converting " << s->name << " from float to integer." << std::endl;
         TypeInfo* int_type = new TypeInfo(TYPE_INTEGER, 4); // Use correct size
         Symbol* temp = new_temp(int_type);
-        emit(OP_FLOAT2INT, temp->name, s->name);
+        emit(OP_FLOAT2INT, temp->name, s->name, "", CLASS_F64);
         return temp;
     }
 
@@ -619,12 +838,10 @@ Symbol* convert_type(Symbol* s, TypeInfo* target_type) {
     }
 
     if (current_type->base == TYPE_CHAR && target_type->base == TYPE_FLOAT) {
-        std::cout << "Debug: Converting " << s->name << " from char to float (via int)." << std::endl;
-        // Treat char as int first, then int to float
+        std::cout << "Debug: Converting " << s->name << " from char to float." << std::endl;
         TypeInfo* float_type = new TypeInfo(TYPE_FLOAT, 8);
         Symbol* temp = new_temp(float_type);
-        // Assuming OP_INT2FLOAT can handle the char implicitly treated as int
-        emit(OP_INT2FLOAT, temp->name, s->name);
+        emit(OP_INT2FLOAT, temp->name, s->name, "", CLASS_I8); // Source class marks the 1-byte operand
         return temp;
     }
 
@@ -647,10 +864,12 @@ BackpatchList mergelist(const BackpatchList& l1, const BackpatchList& l2) {
 }
 
 void backpatch(BackpatchList& list, int target_quad_index) {
+    PhaseTimer timer(PHASE_BACKPATCH);
     std::string target_str = std::to_string(target_quad_index);
     for (int index : list) {
-        if (index >= 0 && index < quad_list.size()) {
-            quad_list[index].result = target_str;
+        int local_index = index - quad_base; // Streamed-out quads are no longer in quad_list
+        if (local_index >= 0 && local_index < (int)quad_list.size()) {
+            quad_list[local_index].result = target_str;
         } else {
              std::cerr << "Warning: Invalid quad index " << index << " during backpatching." << std::endl;
         }
@@ -659,6 +878,7 @@ void backpatch(BackpatchList& list, int target_quad_index) {
 }
 
 void print_symbol_table(SymbolTable* table_to_print, int level) {
+    PhaseTimer timer(PHASE_SYMBOL_TABLE);
     if (!table_to_print) { table_to_print = global_symbol_table; }
     if (!table_to_print) return;
 
@@ -720,6 +940,7 @@ void cleanup_translator() {
     quad_list.clear();
     pending_type_symbols.clear();
     next_quad_index = 0;
+    quad_base = 0;
     temp_counter = 0;
     std::cout << "Translator resources cleaned up (basic)." << std::endl;
 }
\ No newline at end of file
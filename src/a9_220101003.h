@@ -52,9 +52,22 @@ typedef enum {
     OP_FLOAT2INT,
     // Markers
     OP_FUNC_BEGIN,
-    OP_FUNC_END
+    OP_FUNC_END,
+    // Block memory operations from -O loop idioms (appended so stored opcode numbers stay valid)
+    OP_BLOCK_FILL, // result[0 .. arg2 bytes) = arg1, one element of the quad's class at a time
+    OP_BLOCK_COPY, // result[0 .. arg2 bytes) = arg1[0 .. arg2 bytes)
+    OP_TAILCALL    // call arg1 with arg2 params in place of the current frame; its return value is ours
 } op_code;
 
+// Operand class of a quad, chosen when it is emitted so later stages need no symbol
+// lookups: the type of the operation (e.g. OP_PLUS + CLASS_I32 is ADD_I32), the stored
+// value for moves, params and returns, and the source type for conversions.
+// CLASS_I16 is only produced by range narrowing (-O); it is appended so the
+// values stored in IR and cache files stay stable.
+typedef enum {
+    CLASS_NONE, CLASS_I8, CLASS_I32, CLASS_F64, CLASS_PTR, CLASS_I16
+} operand_class;
+
 // Enum for Basic Data Types
 typedef enum {
     TYPE_VOID, TYPE_BOOL, TYPE_CHAR, TYPE_INTEGER, TYPE_FLOAT, 
@@ -112,6 +125,7 @@ struct Symbol {
     bool is_temp = false;
     std::vector<int> pending_dims;
     std::vector<Symbol*> parameters; 
+    int init_quad = -1; // Absolute index of the initializer quad until the declared type is applied
 
     Symbol(std::string n, TypeInfo* t = nullptr, int sz = 0, int off = 0)
         : name(n), type(t), size(sz), offset(off) {}
@@ -142,9 +156,10 @@ struct Quad {
     std::string arg1;
     std::string arg2;
     std::string result; // Target label for jumps, result name otherwise
+    operand_class type_class;
 
-    Quad(op_code o, std::string r, std::string a1 = "", std::string a2 = "") : 
-        op(o), arg1(a1), arg2(a2), result(r) {}
+    Quad(op_code o, std::string r, std::string a1 = "", std::string a2 = "", operand_class c = CLASS_NONE) : 
+        op(o), arg1(a1), arg2(a2), result(r), type_class(c) {}
 
     std::string toString() const;
 };
@@ -157,9 +172,11 @@ extern SymbolTable* global_symbol_table;
 extern SymbolTable* current_symbol_table;
 extern int next_quad_index;
 extern int temp_counter;
+extern int quad_base;       // Absolute index of quad_list[0] (non-zero once streamed quads are dropped)
+extern bool streaming_mode; // Emit and free each function as soon as it is reduced
 
 // 6. FUNCTION PROTOTYPES
-void emit(op_code op, std::string result, std::string arg1 = "", std::string arg2 = "");
+void emit(op_code op, std::string result, std::string arg1 = "", std::string arg2 = "", operand_class type_class = CLASS_NONE);
 void print_quads(const std::string& filename);
 void print_tac(const std::string& filename);
 int get_next_quad_index();
@@ -181,5 +198,105 @@ BackpatchList mergelist(const BackpatchList& l1, const BackpatchList& l2);
 void backpatch(BackpatchList& list, int target_quad_index);
 
 std::string opcode_to_string(op_code op);
+operand_class class_of(const TypeInfo* type);
+std::string class_suffix(operand_class type_class); // ".i32" etc., empty for CLASS_NONE
+int class_size(operand_class type_class); // Bytes of one value of the class, 0 for CLASS_NONE
 
 void cleanup_translator();
+
+// 7. STREAMING OUTPUT
+void format_tac_line(std::string& out, int index, const Quad& quad);
+void format_quad_line(std::string& out, const Quad& quad);
+void begin_streaming_output(const std::string& tac_filename, const std::string& quad_filename);
+void finalize_function(Symbol* func_sym);
+void end_streaming_output();
+SymbolTable* find_function_scope(const std::string& func_name);
+void release_scope(SymbolTable* scope);
+
+// 8. BINARY IR CONTAINER (a9_220101003_ir.cpp)
+extern bool emit_ir_mode;
+void ir_record_quads(const std::vector<Quad>& quads, int first_index);
+void ir_record_function_scope(SymbolTable* scope, Symbol* func_sym, bool releasing);
+bool write_ir_file(const std::string& filename);
+bool load_ir_file(const std::string& filename);
+
+// 9. INCREMENTAL COMPILATION CACHE (a9_220101003_cache.cpp)
+extern std::string cache_dir; // Empty: cache disabled
+extern int cache_hits;
+extern int cache_misses;
+bool cache_enabled();
+void cache_splice_function();               // Emits the cached body of the function being reduced, if any
+void cache_store_function(Symbol* func_sym); // Saves a freshly translated function after a miss
+
+// 10. TRANSLATION STATISTICS (a9_220101003_stats.cpp)
+typedef enum {
+    PHASE_DRIVER, PHASE_LEX, PHASE_PARSE, PHASE_BACKPATCH, PHASE_TYPECHECK,
+    PHASE_SYMBOL_TABLE, PHASE_OUTPUT, PHASE_CACHE, PHASE_OPTIMIZE, PHASE_COUNT
+} stats_phase;
+
+extern bool stats_enabled;
+
+// Charges wall time to a phase for the lifetime of the object (no-op without --stats)
+struct PhaseTimer {
+    bool active;
+    explicit PhaseTimer(stats_phase phase);
+    ~PhaseTimer();
+};
+
+void stats_begin();
+void stats_count_token();
+void stats_count_temp();
+void stats_count_quad(op_code op);
+void stats_record_scope_tree(SymbolTable* table);
+void stats_record_optimized(long quads); // Quad count left after -O
+void stats_mark_stage(const std::string& stage); // Samples peak memory at the end of a pipeline stage
+bool write_stats_report(const std::string& filename, const std::string& input_name);
+
+// 11. TAC INTERPRETER (a9_220101003_interp.cpp)
+bool run_program(const std::string& filename); // Runs main, writes its result and the final globals
+
+// 12. OPTIMIZER (a9_220101003_opt.cpp)
+struct FunctionRange {
+    std::string name;
+    int begin; // Index in quad_list of OP_FUNC_BEGIN
+    int end;   // Index in quad_list of OP_FUNC_END
+};
+
+extern bool optimize_mode;
+void optimize_program();
+bool write_opt_report(const std::string& filename);
+void opt_report(const std::string& pass, const std::string& message);
+bool is_jump_op(op_code op);
+bool is_constant_operand(const std::string& operand);
+bool is_temp_name(const std::string& name);
+std::vector<FunctionRange> find_functions();
+Symbol* local_symbol(const FunctionRange& fn, const std::string& name); // Parameter or local of fn, if any
+
+struct BasicBlock {
+    int begin; // First quad (index in quad_list)
+    int end;   // One past the last quad
+    std::vector<int> succs; // Block indices; a jump to FUNC_END has no successor
+    std::vector<int> preds;
+};
+
+struct FunctionCFG {
+    std::vector<BasicBlock> blocks; // In quad order, blocks[0] is the entry
+    std::vector<int> block_at;      // Block of body quad i at block_at[i - (fn.begin + 1)]
+};
+
+FunctionCFG build_cfg(const FunctionRange& fn);
+
+// Rebuilds quad_list without the removed quads and with the insertions. Jump targets
+// are given in old indices and remapped; a jump to quad i lands on insert_before[i].
+void rewrite_quads(const std::vector<bool>& removed,
+                   const std::map<int, std::vector<Quad>>& insert_before,
+                   const std::map<int, std::vector<Quad>>& insert_after);
+
+// 13. VALUE-RANGE ANALYSIS (a9_220101003_range.cpp)
+void narrow_integer_widths(); // Gives integer quads, temps and locals that fit in 8/16 bits a narrower class
+
+// 14. LOOP IDIOM RECOGNITION (a9_220101003_loops.cpp)
+void recognise_loop_idioms(); // Array fill/copy loops become OP_BLOCK_FILL/OP_BLOCK_COPY
+
+// 15. TAIL-CALL ELIMINATION (a9_220101003_tailcall.cpp)
+void eliminate_tail_calls(); // Self tail calls become jumps to the entry, others OP_TAILCALL
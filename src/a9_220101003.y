@@ -9,6 +9,7 @@
 #include <sstream> 
 #include <utility> 
 #include <libgen.h> 
+#include <chrono>
 
 /* External declarations */
 extern int yylex();
@@ -184,7 +185,7 @@ primary_expression
         TypeInfo* const_type = new TypeInfo(TYPE_INTEGER, 4);
         Symbol* temp = new_temp(const_type);
         std::string const_str = std::to_string($1);
-        emit(OP_ASSIGN, temp->name, const_str);
+        emit(OP_ASSIGN, temp->name, const_str, "", class_of(const_type));
 
         $$ = new ExprAttributes();
         $$->place = temp;
@@ -197,7 +198,7 @@ primary_expression
         std::ostringstream oss;
         oss << std::fixed << $1;
         std::string const_str = oss.str();
-        emit(OP_ASSIGN, temp->name, const_str);
+        emit(OP_ASSIGN, temp->name, const_str, "", class_of(const_type));
 
         $$ = new ExprAttributes();
         $$->place = temp;
@@ -208,7 +209,7 @@ primary_expression
          TypeInfo* const_type = new TypeInfo(TYPE_CHAR, 1);
          Symbol* temp = new_temp(const_type);
          std::string const_str = std::to_string(static_cast<int>($1));
-         emit(OP_ASSIGN, temp->name, const_str);
+         emit(OP_ASSIGN, temp->name, const_str, "", class_of(const_type));
 
          $$ = new ExprAttributes();
          $$->place = temp;
@@ -258,17 +259,17 @@ postfix_expression
                 // Create temporary for element size constant
                 TypeInfo* int_type = new TypeInfo(TYPE_INTEGER, 4); // Assuming int
                 Symbol* size_const_sym = new_temp(int_type);
-                emit(OP_ASSIGN, size_const_sym->name, std::to_string(element_size));
+                emit(OP_ASSIGN, size_const_sym->name, std::to_string(element_size), "", CLASS_I32);
 
                 // Create temporary for offset calculation
                 offset_sym = new_temp(int_type); // Offset is an integer
-                emit(OP_MULT, offset_sym->name, index_sym->name, size_const_sym->name);
+                emit(OP_MULT, offset_sym->name, index_sym->name, size_const_sym->name, CLASS_I32);
                 std::cout << "Debug: Array offset calculation: " << offset_sym->name << " = " << index_sym->name << " * " << element_size << std::endl;
             }
 
             // Create temporary to hold the R-value (value fetched from array)
             Symbol* result_val_sym = new_temp(new TypeInfo(*element_type)); // Copy element type
-            emit(OP_ARRAY_ACCESS, result_val_sym->name, array_attr->place->name, offset_sym->name); // result = array[offset]
+            emit(OP_ARRAY_ACCESS, result_val_sym->name, array_attr->place->name, offset_sym->name, class_of(element_type)); // result = array[offset]
 
             // Create the resulting expression attributes
             $$ = new ExprAttributes();
@@ -316,10 +317,10 @@ postfix_expression
                     TypeInfo* return_type = func_sym->type->return_type;
                     
                     if (return_type && return_type->base != TYPE_VOID) {
-                        // Non-void function: create temporary for return value
-                        $$->place = new_temp(return_type);
-                        $$->type = return_type;
-                        emit(OP_CALL, $$->place->name, func_sym->name, "0"); // 0 parameters
+                        // Non-void function: create temporary for return value (owns a copy of the return type)
+                        $$->place = new_temp(new TypeInfo(*return_type));
+                        $$->type = $$->place->type;
+                        emit(OP_CALL, $$->place->name, func_sym->name, "0", class_of(return_type)); // 0 parameters
                     } else {
                         // Void function: no return value
                         $$->place = nullptr;
@@ -362,15 +363,16 @@ postfix_expression
                     // Emit parameters
                     if ($3->param_names) {
                         for (auto it = $3->param_names->begin(); it != $3->param_names->end(); ++it) {
-                            emit(OP_PARAM, *it);
+                            Symbol* arg_sym = lookup_symbol(*it);
+                            emit(OP_PARAM, *it, "", "", arg_sym ? class_of(arg_sym->type) : CLASS_NONE);
                         }
                     }
                     
                     // Emit function call (existing code)
                     if (return_type && return_type->base != TYPE_VOID) {
-                        $$->place = new_temp(return_type);
-                        $$->type = return_type;
-                        emit(OP_CALL, $$->place->name, func_sym->name, std::to_string(param_count));
+                        $$->place = new_temp(new TypeInfo(*return_type));
+                        $$->type = $$->place->type;
+                        emit(OP_CALL, $$->place->name, func_sym->name, std::to_string(param_count), class_of(return_type));
                     } else {
                         $$->place = nullptr;
                         $$->type = new TypeInfo(TYPE_VOID, 0);
@@ -454,7 +456,7 @@ unary_expression
             TypeInfo* ptr_type = new TypeInfo(TYPE_POINTER, 8);
             ptr_type->ptr_type = new TypeInfo(*(operand_attr->type)); // Copy operand's type
             Symbol* result_temp = new_temp(ptr_type); // Temp to hold the address
-            emit(OP_ADDR, result_temp->name, operand_attr->place->name); // result = &operand
+            emit(OP_ADDR, result_temp->name, operand_attr->place->name, "", CLASS_PTR); // result = &operand
 
             $$ = new ExprAttributes();
             $$->place = result_temp; // Place holds the address temp
@@ -480,7 +482,7 @@ unary_expression
              Symbol* result_temp = new_temp(pointed_to_type);
 
              // Emit the dereference TAC immediately: temp = *pointer
-             emit(OP_ASSIGN_DEREF, result_temp->name, operand_attr->place->name);
+             emit(OP_ASSIGN_DEREF, result_temp->name, operand_attr->place->name, "", class_of(pointed_to_type));
 
              $$ = new ExprAttributes();
              $$->place = result_temp; // Place now holds the temporary containing the value
@@ -517,8 +519,11 @@ unary_expression
                 if (!temp_result_base_type) { yyerror("Invalid type for unary operator"); delete operand_attr; $$ = nullptr; }
                 else {
                      Symbol* operand_place = operand_attr->place;
+                     if (temp_result_base_type == operand_attr->type) { // typecheck passes int/float operand types through
+                         temp_result_base_type = new TypeInfo(*temp_result_base_type);
+                     }
                      Symbol* result_temp = new_temp(temp_result_base_type);
-                     emit(op, result_temp->name, operand_place->name);
+                     emit(op, result_temp->name, operand_place->name, "", class_of(temp_result_base_type));
 
                      $$ = new ExprAttributes(); $$->place = result_temp; $$->type = result_temp->type; /* No lists */
                      std::cout << "Debug: Unary Op " << opcode_to_string(op) << " -> " << result_temp->name << std::endl;
@@ -560,7 +565,7 @@ multiplicative_expression
                 if (left_operand != left_attr->place || right_operand != right_attr->place) { std::cout << "Debug: Conversion applied for " << opcode_to_string(OP_MULT) << std::endl; }
 
                 Symbol* result_temp = new_temp(temp_result_base_type);
-                emit(OP_MULT, result_temp->name, left_operand->name, right_operand->name);
+                emit(OP_MULT, result_temp->name, left_operand->name, right_operand->name, class_of(temp_result_base_type));
 
                 $$ = new ExprAttributes();
                 $$->place = result_temp;
@@ -593,7 +598,7 @@ multiplicative_expression
                 if (left_operand != left_attr->place || right_operand != right_attr->place) { std::cout << "Debug: Conversion applied for " << opcode_to_string(OP_DIV) << std::endl; }
 
                 Symbol* result_temp = new_temp(temp_result_base_type);
-                emit(OP_DIV, result_temp->name, left_operand->name, right_operand->name);
+                emit(OP_DIV, result_temp->name, left_operand->name, right_operand->name, class_of(temp_result_base_type));
 
                 $$ = new ExprAttributes();
                 $$->place = result_temp;
@@ -626,7 +631,7 @@ multiplicative_expression
                 if (left_operand != left_attr->place || right_operand != right_attr->place) { std::cout << "Debug: Conversion applied for " << opcode_to_string(OP_MOD) << std::endl; }
 
                 Symbol* result_temp = new_temp(temp_result_base_type);
-                emit(OP_MOD, result_temp->name, left_operand->name, right_operand->name);
+                emit(OP_MOD, result_temp->name, left_operand->name, right_operand->name, class_of(temp_result_base_type));
 
                 $$ = new ExprAttributes();
                 $$->place = result_temp;
@@ -663,7 +668,7 @@ additive_expression
                 if (left_operand != left_attr->place || right_operand != right_attr->place) { std::cout << "Debug: Conversion applied for " << opcode_to_string(OP_PLUS) << std::endl; }
 
                 Symbol* result_temp = new_temp(temp_result_base_type);
-                emit(OP_PLUS, result_temp->name, left_operand->name, right_operand->name);
+                emit(OP_PLUS, result_temp->name, left_operand->name, right_operand->name, class_of(temp_result_base_type));
 
                 $$ = new ExprAttributes();
                 $$->place = result_temp;
@@ -696,7 +701,7 @@ additive_expression
                 if (left_operand != left_attr->place || right_operand != right_attr->place) { std::cout << "Debug: Conversion applied for " << opcode_to_string(OP_MINUS) << std::endl; }
 
                 Symbol* result_temp = new_temp(temp_result_base_type);
-                emit(OP_MINUS, result_temp->name, left_operand->name, right_operand->name);
+                emit(OP_MINUS, result_temp->name, left_operand->name, right_operand->name, class_of(temp_result_base_type));
 
                 $$ = new ExprAttributes();
                 $$->place = result_temp;
@@ -718,13 +723,13 @@ relational_expression
             if (!bool_type) { yyerror("Type mismatch for '<'"); delete left_attr; delete right_attr; $$ = nullptr; }
             else { delete bool_type; /* Only needed for check */
                 TypeInfo* cmp_type = (left_attr->type->base == TYPE_FLOAT || right_attr->type->base == TYPE_FLOAT) ? new TypeInfo(TYPE_FLOAT, 8) : new TypeInfo(TYPE_INTEGER, 4);
-                Symbol* lop = convert_type(left_attr->place, cmp_type); Symbol* rop = convert_type(right_attr->place, cmp_type); delete cmp_type;
+                Symbol* lop = convert_type(left_attr->place, cmp_type); Symbol* rop = convert_type(right_attr->place, cmp_type); operand_class cmp_class = class_of(cmp_type); delete cmp_type;
 
                 $$ = new ExprAttributes(); $$->type = new TypeInfo(TYPE_BOOL, 1);
                 $$->truelist = new BackpatchList(makelist(get_next_quad_index()));
                 $$->falselist = new BackpatchList(makelist(get_next_quad_index() + 1));
 
-                emit(OP_IF_LT, "", lop->name, rop->name);
+                emit(OP_IF_LT, "", lop->name, rop->name, cmp_class);
                 emit(OP_GOTO, "");
 
                 std::cout << "Debug: Relational Op < generated jumps" << std::endl;
@@ -737,12 +742,12 @@ relational_expression
             if (!bool_type) { yyerror("Type mismatch for '>'"); delete left_attr; delete right_attr; $$ = nullptr; }
             else { delete bool_type;
                 TypeInfo* cmp_type = (left_attr->type->base == TYPE_FLOAT || right_attr->type->base == TYPE_FLOAT) ? new TypeInfo(TYPE_FLOAT, 8) : new TypeInfo(TYPE_INTEGER, 4);
-                Symbol* lop = convert_type(left_attr->place, cmp_type); Symbol* rop = convert_type(right_attr->place, cmp_type); delete cmp_type;
+                Symbol* lop = convert_type(left_attr->place, cmp_type); Symbol* rop = convert_type(right_attr->place, cmp_type); operand_class cmp_class = class_of(cmp_type); delete cmp_type;
 
                 $$ = new ExprAttributes(); $$->type = new TypeInfo(TYPE_BOOL, 1);
                 $$->truelist = new BackpatchList(makelist(get_next_quad_index())); $$->falselist = new BackpatchList(makelist(get_next_quad_index() + 1));
 
-                emit(OP_IF_GT, "", lop->name, rop->name); emit(OP_GOTO, "");
+                emit(OP_IF_GT, "", lop->name, rop->name, cmp_class); emit(OP_GOTO, "");
 
                 std::cout << "Debug: Relational Op > generated jumps" << std::endl;
                 delete left_attr; delete right_attr; } }
@@ -754,12 +759,12 @@ relational_expression
             if (!bool_type) { yyerror("Type mismatch for '<='"); delete left_attr; delete right_attr; $$ = nullptr; }
             else { delete bool_type;
                 TypeInfo* cmp_type = (left_attr->type->base == TYPE_FLOAT || right_attr->type->base == TYPE_FLOAT) ? new TypeInfo(TYPE_FLOAT, 8) : new TypeInfo(TYPE_INTEGER, 4);
-                Symbol* lop = convert_type(left_attr->place, cmp_type); Symbol* rop = convert_type(right_attr->place, cmp_type); delete cmp_type;
+                Symbol* lop = convert_type(left_attr->place, cmp_type); Symbol* rop = convert_type(right_attr->place, cmp_type); operand_class cmp_class = class_of(cmp_type); delete cmp_type;
 
                 $$ = new ExprAttributes(); $$->type = new TypeInfo(TYPE_BOOL, 1);
                 $$->truelist = new BackpatchList(makelist(get_next_quad_index())); $$->falselist = new BackpatchList(makelist(get_next_quad_index() + 1));
 
-                emit(OP_IF_LE, "", lop->name, rop->name); emit(OP_GOTO, "");
+                emit(OP_IF_LE, "", lop->name, rop->name, cmp_class); emit(OP_GOTO, "");
 
                 std::cout << "Debug: Relational Op <= generated jumps" << std::endl;
                 delete left_attr; delete right_attr; } }
@@ -779,12 +784,12 @@ relational_expression
             }else { 
                 delete bool_type;
                 TypeInfo* cmp_type = (left_attr->type->base == TYPE_FLOAT || right_attr->type->base == TYPE_FLOAT) ? new TypeInfo(TYPE_FLOAT, 8) : new TypeInfo(TYPE_INTEGER, 4);
-                Symbol* lop = convert_type(left_attr->place, cmp_type); Symbol* rop = convert_type(right_attr->place, cmp_type); delete cmp_type;
+                Symbol* lop = convert_type(left_attr->place, cmp_type); Symbol* rop = convert_type(right_attr->place, cmp_type); operand_class cmp_class = class_of(cmp_type); delete cmp_type;
 
                 $$ = new ExprAttributes(); $$->type = new TypeInfo(TYPE_BOOL, 1);
                 $$->truelist = new BackpatchList(makelist(get_next_quad_index())); $$->falselist = new BackpatchList(makelist(get_next_quad_index() + 1));
 
-                emit(OP_IF_GE, "", lop->name, rop->name); emit(OP_GOTO, "");
+                emit(OP_IF_GE, "", lop->name, rop->name, cmp_class); emit(OP_GOTO, "");
                 std::cout << "Debug: Relational Op >= generated jumps" << std::endl;
                 delete left_attr; delete right_attr; 
             } 
@@ -801,12 +806,12 @@ equality_expression
             if (!bool_type) { yyerror("Type mismatch for '=='"); delete left_attr; delete right_attr; $$ = nullptr; }
             else { delete bool_type;
                 TypeInfo* cmp_type = (left_attr->type->base == TYPE_FLOAT || right_attr->type->base == TYPE_FLOAT) ? new TypeInfo(TYPE_FLOAT, 8) : new TypeInfo(TYPE_INTEGER, 4);
-                Symbol* lop = convert_type(left_attr->place, cmp_type); Symbol* rop = convert_type(right_attr->place, cmp_type); delete cmp_type;
+                Symbol* lop = convert_type(left_attr->place, cmp_type); Symbol* rop = convert_type(right_attr->place, cmp_type); operand_class cmp_class = class_of(cmp_type); delete cmp_type;
 
                 $$ = new ExprAttributes(); $$->type = new TypeInfo(TYPE_BOOL, 1);
                 $$->truelist = new BackpatchList(makelist(get_next_quad_index())); $$->falselist = new BackpatchList(makelist(get_next_quad_index() + 1));
 
-                emit(OP_IF_EQ, "", lop->name, rop->name); emit(OP_GOTO, "");
+                emit(OP_IF_EQ, "", lop->name, rop->name, cmp_class); emit(OP_GOTO, "");
 
                 std::cout << "Debug: Equality Op == generated jumps" << std::endl;
                 delete left_attr; delete right_attr; } }
@@ -818,12 +823,12 @@ equality_expression
             if (!bool_type) { yyerror("Type mismatch for '!='"); delete left_attr; delete right_attr; $$ = nullptr; }
             else { delete bool_type;
                 TypeInfo* cmp_type = (left_attr->type->base == TYPE_FLOAT || right_attr->type->base == TYPE_FLOAT) ? new TypeInfo(TYPE_FLOAT, 8) : new TypeInfo(TYPE_INTEGER, 4);
-                Symbol* lop = convert_type(left_attr->place, cmp_type); Symbol* rop = convert_type(right_attr->place, cmp_type); delete cmp_type;
+                Symbol* lop = convert_type(left_attr->place, cmp_type); Symbol* rop = convert_type(right_attr->place, cmp_type); operand_class cmp_class = class_of(cmp_type); delete cmp_type;
 
                 $$ = new ExprAttributes(); $$->type = new TypeInfo(TYPE_BOOL, 1);
                 $$->truelist = new BackpatchList(makelist(get_next_quad_index())); $$->falselist = new BackpatchList(makelist(get_next_quad_index() + 1));
 
-                emit(OP_IF_NE, "", lop->name, rop->name); emit(OP_GOTO, "");
+                emit(OP_IF_NE, "", lop->name, rop->name, cmp_class); emit(OP_GOTO, "");
 
                 std::cout << "Debug: Equality Op != generated jumps" << std::endl;
                 delete left_attr; delete right_attr; } }
@@ -919,7 +924,7 @@ assignment_expression
                          std::cout << "Debug: Types match for *p= assignment, no conversion needed." << std::endl;
                     }
 
-                    emit(OP_DEREF_ASSIGN, lhs_attr->pointer_sym_for_lvalue->name, rhs_operand->name); // *p = rhs
+                    emit(OP_DEREF_ASSIGN, lhs_attr->pointer_sym_for_lvalue->name, rhs_operand->name, "", class_of(target_type)); // *p = rhs
 
                     $$ = new ExprAttributes();
                     $$->place = rhs_operand; // Result of assignment is RHS value
@@ -964,7 +969,7 @@ assignment_expression
                     }
 
                     // Emit the array assignment quad
-                    emit(OP_ARRAY_ASSIGN, lhs_attr->array_base_sym->name, lhs_attr->array_offset_sym->name, rhs_operand->name); // array[offset] = rhs
+                    emit(OP_ARRAY_ASSIGN, lhs_attr->array_base_sym->name, lhs_attr->array_offset_sym->name, rhs_operand->name, class_of(target_type)); // array[offset] = rhs
 
                     $$ = new ExprAttributes();
                     $$->place = rhs_operand; // Result of assignment is RHS value
@@ -976,8 +981,7 @@ assignment_expression
                     std::cout << "Debug: Array Assignment: " << lhs_attr->array_base_sym->name
                               << "[" << lhs_attr->array_offset_sym->name << "] = " << rhs_operand->name << std::endl;
 
-                    // Cleanup: lhs_attr->type was a copy created in postfix rule.
-                    delete lhs_attr->type;
+                    // Cleanup: lhs_attr->type is the element-type copy owned by the fetched temp symbol.
                     delete lhs_attr;
                     delete rhs_attr;
                 }
@@ -1013,7 +1017,7 @@ assignment_expression
                          std::cout << "Debug: Types match for assignment, no conversion needed." << std::endl;
                      }
 
-                     emit(OP_ASSIGN, lhs_attr->place->name, rhs_operand->name); // variable = rhs
+                     emit(OP_ASSIGN, lhs_attr->place->name, rhs_operand->name, "", class_of(target_type)); // variable = rhs
 
                      $$ = new ExprAttributes();
                      $$->place = rhs_operand; // Result of assignment is RHS value
@@ -1097,6 +1101,7 @@ init_declarator
                   // Emit raw assignment - type check/conversion happens later in apply_pending_types
                   if (init_attr->place) {
                       emit(OP_ASSIGN, sym->name, init_attr->place->name);
+                      sym->init_quad = get_next_quad_index() - 1; // Class set once the type is applied
                       std::cout << "Debug: Emitted initializer assign (NO TYPE CHECK/CONV): " << sym->name << " = " << init_attr->place->name << std::endl;
                   } else {
                        yyerror(("Invalid initializer value for '" + var_name + "'").c_str());
@@ -1515,7 +1520,8 @@ iteration_statement
           Quad jump_to_cond(OP_GOTO, std::to_string(cond_marker->front()));
           
           // Insert this quad just before the body code starts
-          quad_list.insert(quad_list.begin() + body_start, jump_to_cond);
+          quad_list.insert(quad_list.begin() + (body_start - quad_base), jump_to_cond);
+          if (stats_enabled) stats_count_quad(OP_GOTO); // Bypasses emit()
           
           // Adjust next_quad_index to account for the insertion
           next_quad_index++;
@@ -1601,7 +1607,7 @@ jump_statement
                     Symbol* converted_value = convert_type(return_value, expected_type);
                     
                     // Emit return quad with (possibly converted) value
-                    emit(OP_RETURN, converted_value->name);
+                    emit(OP_RETURN, converted_value->name, "", "", class_of(expected_type));
                     
                     std::cout << "Debug: Generated return with value " << converted_value->name << std::endl;
                     
@@ -1680,7 +1686,9 @@ function_definition
         {
             // Action 2: After the compound statement
             if (current_function) { 
+                cache_splice_function(); // Body quads come from the cache when its tokens were skipped
                 emit(OP_FUNC_END, current_function->name);
+                finalize_function(current_function); // Caches, then streams out and frees the body in --stream mode
                 current_function = nullptr; // Reset context
             }
             $$ = $4; // Propagate statement attributes from compound_statement
@@ -1696,39 +1704,135 @@ void yyerror(const char* s) {
     exit(EXIT_FAILURE);
 }
 
+static void print_usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options] <input_file>" << std::endl
+              << "Options:" << std::endl
+              << "  --stream    Write and free each function as soon as it is parsed" << std::endl
+              << "  --emit-ir   Also write the binary IR to output/<input_file>.ir" << std::endl
+              << "  --from-ir   Input is a binary IR file; regenerate .tac/.quad from it" << std::endl
+              << "  --cache-dir <dir>  Reuse translated function bodies cached in <dir>" << std::endl
+              << "  --stats     Write per-phase timings and counts to output/<input_file>.stats.json" << std::endl
+              << "  -O          Optimize: interprocedural constant propagation, dead-call and dead-function" << std::endl
+              << "              elimination, fill/copy loops to block_fill/block_copy, tail calls to loops or" << std::endl
+              << "              tailcall, and 8/16-bit integer narrowing; writes output/<input_file>.report" << std::endl
+              << "  --run       Execute the generated TAC; write main's result and the globals to output/<input_file>.run" << std::endl;
+}
+
+/* Regenerates the outputs from a saved binary IR file instead of parsing source; the
+   loaded program goes through the same later stages (-O, --run, --stats) as a parsed one */
+static int translate_from_ir(const std::string& ir_path, const std::string& output_dir, bool run_mode) {
+    char* ir_path_cstr = strdup(ir_path.c_str());
+    std::string base_name = basename(ir_path_cstr);
+    free(ir_path_cstr);
+    if (base_name.size() > 3 && base_name.compare(base_name.size() - 3, 3, ".ir") == 0) {
+        base_name.erase(base_name.size() - 3);
+    }
+
+    auto load_start = std::chrono::steady_clock::now();
+    {
+        PhaseTimer timer(PHASE_PARSE); // Loading stands in for parsing
+        if (!load_ir_file(ir_path)) { return 1; }
+    }
+    double load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_start).count();
+    std::cout << "Loaded IR from " << ir_path << ": " << quad_list.size() << " quads in " << load_ms << " ms" << std::endl;
+    if (stats_enabled) { for (const Quad& quad : quad_list) stats_count_quad(quad.op); }
+    stats_mark_stage("load");
+
+    if (optimize_mode) { optimize_program(); write_opt_report(output_dir + base_name + ".report"); }
+    print_symbol_table(global_symbol_table);
+    stats_mark_stage("symbol_table");
+    print_tac(output_dir + base_name + ".tac");
+    print_quads(output_dir + base_name + ".quad");
+    stats_mark_stage("output");
+    if (run_mode) { run_program(output_dir + base_name + ".run"); }
+    if (stats_enabled) {
+        stats_record_scope_tree(global_symbol_table);
+        write_stats_report(output_dir + base_name + ".stats.json", ir_path);
+    }
+
+    cleanup_translator();
+    return 0;
+}
+
 int main(int argc, char** argv) {
-    if (argc < 2) { std::cerr << "Usage: " << argv[0] << " <input_file>" << std::endl; return 1; }
-    yyin = fopen(argv[1], "r");
-    if (!yyin) { std::cerr << "Error: Cannot open input file: " << argv[1] << std::endl; return 1; }
+    /* Command-line options (must precede the input file) */
+    bool from_ir_mode = false;
+    bool run_mode = false;
+    int arg_index = 1;
+    for (; arg_index < argc && argv[arg_index][0] == '-'; ++arg_index) {
+        std::string opt = argv[arg_index];
+        if (opt == "--stream") { streaming_mode = true; }
+        else if (opt == "--emit-ir") { emit_ir_mode = true; }
+        else if (opt == "--from-ir") { from_ir_mode = true; }
+        else if (opt == "--cache-dir" && arg_index + 1 < argc) { cache_dir = argv[++arg_index]; }
+        else if (opt == "--stats") { stats_begin(); }
+        else if (opt == "--run") { run_mode = true; }
+        else if (opt == "-O") { optimize_mode = true; }
+        else { std::cerr << "Error: Unknown option: " << opt << std::endl; print_usage(argv[0]); return 1; }
+    }
+    if (arg_index >= argc) { print_usage(argv[0]); return 1; }
+    if (run_mode && streaming_mode) { std::cerr << "Error: --run needs the whole program in memory and cannot be combined with --stream" << std::endl; return 1; }
+    if (from_ir_mode && (streaming_mode || emit_ir_mode || cache_enabled())) {
+        std::cerr << "Error: --from-ir reads a whole translated program and cannot be combined with --stream, --emit-ir or --cache-dir" << std::endl;
+        return 1;
+    }
+    const char* input_path = argv[arg_index];
+
+    std::string output_dir = "output/";
+    if (from_ir_mode) { return translate_from_ir(input_path, output_dir, run_mode); }
+
+    yyin = fopen(input_path, "r");
+    if (!yyin) { std::cerr << "Error: Cannot open input file: " << input_path << std::endl; return 1; }
 
     /* Lexer Output File Handling */
-    std::string input_path_str = argv[1];
+    std::string input_path_str = input_path;
     char* input_path_cstr = strdup(input_path_str.c_str()); 
     std::string base_name = basename(input_path_cstr); 
     free(input_path_cstr); // Free the duplicated string
 
-    std::string output_dir = "output/";
-
     std::string lex_filename_str = output_dir + base_name + ".lex.out";
 
     lex_output = fopen(lex_filename_str.c_str(), "w");
     if (!lex_output) { std::cerr << "Warning: Cannot create lexer output file: " << lex_filename_str << std::endl; }
     else { std::cout << "Lexical analysis output will be written to " << lex_filename_str << std::endl; fprintf(lex_output, "LEXICAL ANALYSIS FOR FILE: %s\n---\n", base_name.c_str()); }
 
+    std::string tac_filename_str = output_dir + base_name + ".tac";
+    std::string quad_filename_str = output_dir + base_name + ".quad";
+
     initialize_symbol_tables();
-    std::cout << "Starting parse for file: " << argv[1] << std::endl;
-    int parse_result = yyparse();
+    if (streaming_mode) { begin_streaming_output(tac_filename_str, quad_filename_str); }
+    std::cout << "Starting parse for file: " << input_path << std::endl;
+    int parse_result;
+    {
+        PhaseTimer timer(PHASE_PARSE); // Semantic actions; nested phases are charged separately
+        parse_result = yyparse();
+    }
     fclose(yyin);
 
     if (parse_result == 0) {
         std::cout << "Parsing completed successfully." << std::endl;
+        stats_mark_stage("parse");
+        if (optimize_mode) {
+            if (streaming_mode) { std::cerr << "Warning: -O needs the whole program in memory; skipped with --stream" << std::endl; }
+            else { optimize_program(); write_opt_report(output_dir + base_name + ".report"); }
+        }
         print_symbol_table(global_symbol_table);
+        stats_mark_stage("symbol_table");
 
-        std::string tac_filename_str = output_dir + base_name + ".tac";
-        std::string quad_filename_str = output_dir + base_name + ".quad";
-
-        print_tac(tac_filename_str); // Pass the full path
-        print_quads(quad_filename_str); // Pass the full path
+        if (streaming_mode) {
+            end_streaming_output(); // Function bodies were already written as they were parsed
+        } else {
+            print_tac(tac_filename_str); // Pass the full path
+            print_quads(quad_filename_str); // Pass the full path
+        }
+        if (emit_ir_mode) { PhaseTimer timer(PHASE_OUTPUT); write_ir_file(output_dir + base_name + ".ir"); }
+        stats_mark_stage("output");
+        if (run_mode) { run_program(output_dir + base_name + ".run"); }
+        if (cache_enabled()) { std::cout << "Cache: " << cache_hits << " hits, " << cache_misses << " misses" << std::endl; }
+        if (stats_enabled) {
+            stats_record_scope_tree(global_symbol_table);
+            write_stats_report(output_dir + base_name + ".stats.json", input_path);
+        }
 
     } else { std::cerr << "Parsing failed." << std::endl; }
 
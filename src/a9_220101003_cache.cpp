@@ -0,0 +1,558 @@
+#include "a9_220101003.h"
+#include "a9_220101003.tab.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <set>
+#include <sys/stat.h> // mkdir()
+
+// --- Incremental Compilation Cache ---
+// The parser reads tokens through yylex() below. Outside a function body the
+// tokens pass straight through. When the BEGIN of a function body has been
+// returned, the whole body (up to the matching END) is buffered and hashed,
+// together with the function's signature and the signatures of every global
+// and callee the body names. On a hit only the END token is handed to the
+// parser, so none of the body's semantic actions run; the cached quads are
+// spliced in before FUNC_END instead, and the locals, temporaries and nested
+// block scopes the body would have declared are rebuilt under the function's
+// scope. On a miss the buffered tokens are replayed and the finished quads and
+// scope tree are stored when the function is finalized.
+//
+// Cached quads are position independent: temporaries are numbered relative to
+// the function's first temp and jump targets relative to its first body quad.
+
+extern int scan_token();  // Flex scanner (YY_DECL in a9_220101003.l)
+extern int line_no;
+extern char* yytext;
+
+static const char CACHE_MAGIC[4] = {'M', 'C', 'F', 'C'};
+static const uint32_t CACHE_VERSION = 3;
+
+enum {
+    RELOC_ARG1_TEMP = 1,
+    RELOC_ARG2_TEMP = 2,
+    RELOC_RESULT_TEMP = 4,
+    RELOC_RESULT_TARGET = 8
+};
+
+struct CachedQuad {
+    Quad quad;
+    uint32_t reloc; // RELOC_* flags: which fields are function-relative
+};
+
+struct BufferedToken {
+    int code;
+    YYSTYPE value;
+    std::string text;
+    int line;
+};
+
+std::string cache_dir;   // Empty: cache disabled
+int cache_hits = 0;
+int cache_misses = 0;
+
+static std::deque<BufferedToken> replay_queue;
+static int scanner_line_no = 1;    // line_no as the scanner left it, while replaying
+static int body_depth = 0;         // BEGIN/END nesting at the parser's read position
+static bool body_next = false;     // The next token is the first of a function body
+
+// Per-function state between the body decision and finalize_function()
+static std::string pending_key;         // Set on a miss: store the result under this key
+static int pending_temp_start = 0;
+static std::vector<CachedQuad> hit_quads;     // Set on a hit: splice these before FUNC_END
+static SymbolTable* hit_scope = nullptr;      // Set on a hit: the body's symbols and block scopes, detached
+static std::vector<Symbol*> hit_temps;        // Temporaries of hit_scope, named relative to the first temp
+static int hit_temp_count = 0;
+static bool hit_pending = false;
+
+bool cache_enabled() {
+    return !cache_dir.empty();
+}
+
+// Anything that changes the generated quads for an unchanged body goes here.
+// -O is deliberately not part of it: entries hold the quads as translated, before
+// optimisation, and -O always reruns on the whole program after parsing. Its
+// passes are not per-function: constant arguments, folded return values and
+// removed calls depend on the callers and callees, so a function's optimised
+// body can change when only another function changed.
+static std::string cache_key_salt() {
+    return "microC-cache-v" + std::to_string(CACHE_VERSION);
+}
+
+static uint64_t fnv1a64(const std::string& data) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static std::string cache_entry_path(const std::string& key) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.fc", (unsigned long long)fnv1a64(key));
+    return cache_dir + "/" + name;
+}
+
+static bool is_jump(op_code op) {
+    return op == OP_GOTO || op == OP_IF_FALSE || op == OP_IF_TRUE || (op >= OP_IF_LT && op <= OP_IF_NE);
+}
+
+static std::string build_key(Symbol* func_sym, const std::vector<BufferedToken>& body) {
+    std::string key = cache_key_salt();
+    key += "\nfn " + func_sym->name + ":" + (func_sym->type ? func_sym->type->toString() : "?");
+    for (Symbol* param : func_sym->parameters) key += " " + param->name;
+
+    key += "\ntokens";
+    std::set<std::string> names;
+    for (const BufferedToken& tok : body) {
+        key += " " + std::to_string(tok.code) + ":" + tok.text;
+        if (tok.code == IDENTIFIER) names.insert(tok.text);
+    }
+
+    // Globals and callees referenced by the body, as currently declared
+    key += "\nglobals";
+    for (const std::string& name : names) {
+        Symbol* sym = global_symbol_table ? global_symbol_table->lookup(name) : nullptr;
+        key += " " + name + ":" + (sym && sym->type ? sym->type->toString() : "-");
+    }
+    return key;
+}
+
+// --- Entry file I/O (one file per function, read with a single fread) ---
+static void put_u32(std::string& out, uint32_t v) { out.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+static void put_str(std::string& out, const std::string& s) { put_u32(out, s.size()); out += s; }
+
+struct EntryReader {
+    const std::string& data;
+    size_t pos = 0;
+    bool ok = true;
+    explicit EntryReader(const std::string& d) : data(d) {}
+    uint32_t u32() {
+        uint32_t v = 0;
+        if (pos + sizeof(v) > data.size()) { ok = false; return 0; }
+        memcpy(&v, data.data() + pos, sizeof(v));
+        pos += sizeof(v);
+        return v;
+    }
+    std::string str() {
+        uint32_t n = u32();
+        if (!ok || pos + n > data.size()) { ok = false; return ""; }
+        std::string s = data.substr(pos, n);
+        pos += n;
+        return s;
+    }
+    // A count of items that each take at least `item_bytes` more bytes of the entry
+    uint32_t count(size_t item_bytes) {
+        uint32_t n = u32();
+        if (ok && n > (data.size() - pos) / item_bytes) ok = false;
+        return ok ? n : 0;
+    }
+};
+
+static bool read_file(const std::string& path, std::string& data) {
+    FILE* in = fopen(path.c_str(), "rb");
+    if (!in) return false;
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    data.resize(size > 0 ? size : 0);
+    bool ok = size >= 0 && fread(&data[0], 1, data.size(), in) == data.size();
+    fclose(in);
+    return ok;
+}
+
+static void collect_temp_names(SymbolTable* table, std::set<std::string>& temps) {
+    for (const auto& [name, symbol] : table->symbols) {
+        if (symbol && symbol->is_temp) temps.insert(name);
+    }
+    for (SymbolTable* child : table->child_scopes) collect_temp_names(child, temps);
+}
+
+static std::string relative_temp(const std::string& name, const std::set<std::string>& temps, int temp_start, bool& relocated) {
+    relocated = temps.count(name) != 0;
+    return relocated ? std::to_string(atoi(name.c_str() + 1) - temp_start) : name;
+}
+
+// Types of a scope tree are stored once each, as a table, so types shared between
+// symbols (e.g. by the temporaries of an array access) are shared again when loaded.
+// A type that belongs to a parameter is stored as a reference to that parameter.
+static const uint32_t TYPE_NONE = 0xFFFFFFFFu;
+
+struct TypeTable {
+    std::vector<const TypeInfo*> types;
+    std::map<const TypeInfo*, uint32_t> ids;
+    std::map<const TypeInfo*, uint32_t> param_of; // Type -> parameter position
+
+    uint32_t add(const TypeInfo* type) {
+        if (!type) return TYPE_NONE;
+        auto it = ids.find(type);
+        if (it != ids.end()) return it->second;
+        uint32_t id = types.size();
+        ids[type] = id;
+        types.push_back(type);
+        if (param_of.count(type)) return id; // Taken from the parameter as it is
+        add(type->ptr_type);
+        add(type->return_type);
+        for (const TypeInfo* param : type->param_types) add(param);
+        return id;
+    }
+
+    void write(std::string& out) const {
+        put_u32(out, types.size());
+        for (const TypeInfo* type : types) {
+            auto param = param_of.find(type);
+            put_u32(out, param != param_of.end() ? param->second : TYPE_NONE);
+            if (param != param_of.end()) continue;
+            put_u32(out, type->base);
+            put_u32(out, type->width);
+            put_u32(out, type->dims.size());
+            for (int dim : type->dims) put_u32(out, dim);
+            put_u32(out, type->ptr_type ? ids.at(type->ptr_type) : TYPE_NONE);
+            put_u32(out, type->return_type ? ids.at(type->return_type) : TYPE_NONE);
+            put_u32(out, type->param_types.size());
+            for (const TypeInfo* p : type->param_types) put_u32(out, p ? ids.at(p) : TYPE_NONE);
+        }
+    }
+};
+
+static void collect_types(SymbolTable* table, TypeTable& types) {
+    for (const auto& [name, symbol] : table->symbols) if (symbol) types.add(symbol->type);
+    for (SymbolTable* child : table->child_scopes) collect_types(child, types);
+}
+
+// Reads a type table written by TypeTable::write; false if it is malformed
+static bool read_types(EntryReader& in, const std::vector<Symbol*>& params, std::vector<TypeInfo*>& types) {
+    uint32_t count = in.count(sizeof(uint32_t));
+    std::vector<std::vector<uint32_t>> links(count); // ptr, return, params...
+    for (uint32_t i = 0; i < count && in.ok; ++i) {
+        uint32_t param = in.u32();
+        if (param != TYPE_NONE) {
+            if (param >= params.size() || !params[param] || !params[param]->type) in.ok = false;
+            types.push_back(in.ok ? params[param]->type : nullptr);
+            continue;
+        }
+        base_type base = (base_type)in.u32();
+        int width = (int)in.u32();
+        TypeInfo* type = new TypeInfo(base, width);
+        types.push_back(type);
+        uint32_t dims = in.count(sizeof(uint32_t));
+        for (uint32_t d = 0; d < dims; ++d) type->dims.push_back((int)in.u32());
+        links[i].push_back(in.u32());
+        links[i].push_back(in.u32());
+        uint32_t param_types = in.count(sizeof(uint32_t));
+        for (uint32_t p = 0; p < param_types; ++p) links[i].push_back(in.u32());
+    }
+    auto type_at = [&](uint32_t id) -> TypeInfo* {
+        if (id == TYPE_NONE) return nullptr;
+        if (id >= types.size()) { in.ok = false; return nullptr; }
+        return types[id];
+    };
+    for (uint32_t i = 0; i < count && in.ok; ++i) {
+        if (links[i].empty()) continue; // A parameter's type
+        TypeInfo* type = types[i];
+        type->ptr_type = type_at(links[i][0]);
+        type->return_type = type_at(links[i][1]);
+        for (size_t p = 2; p < links[i].size(); ++p) type->param_types.push_back(type_at(links[i][p]));
+    }
+    return in.ok;
+}
+
+// Scope tree of a function body: name, symbols (temporaries named relative to the
+// function's first temp), then the nested block scopes in order
+static void write_scope(std::string& out, SymbolTable* table, const std::vector<Symbol*>& skip,
+                        const TypeTable& types, const std::set<std::string>& temps, int temp_start) {
+    put_str(out, table->scope_name);
+    uint32_t count = 0;
+    for (const auto& [name, symbol] : table->symbols) {
+        if (symbol && std::find(skip.begin(), skip.end(), symbol) == skip.end()) count++;
+    }
+    put_u32(out, count);
+    for (const auto& [name, symbol] : table->symbols) {
+        if (!symbol || std::find(skip.begin(), skip.end(), symbol) != skip.end()) continue;
+        bool relocated = false;
+        put_str(out, relative_temp(name, temps, temp_start, relocated));
+        put_u32(out, (symbol->is_temp ? 1 : 0) | (relocated ? 2 : 0));
+        put_str(out, symbol->initial_value);
+        put_u32(out, symbol->size);
+        put_u32(out, symbol->offset);
+        put_u32(out, symbol->type ? types.ids.at(symbol->type) : TYPE_NONE);
+    }
+    put_u32(out, table->child_scopes.size());
+    for (SymbolTable* child : table->child_scopes) write_scope(out, child, {}, types, temps, temp_start);
+}
+
+// Detached copy of a stored scope tree; relocated temporaries are also listed in temps
+static SymbolTable* read_scope(EntryReader& in, SymbolTable* parent, const std::vector<TypeInfo*>& types,
+                               std::vector<Symbol*>& temps, int depth = 0) {
+    SymbolTable* table = new SymbolTable(parent, parent ? parent->scope_level + 1 : 0, in.str());
+    if (parent) parent->child_scopes.push_back(table);
+    uint32_t symbols = in.count(5 * sizeof(uint32_t));
+    for (uint32_t i = 0; i < symbols && in.ok; ++i) {
+        std::string name = in.str();
+        uint32_t flags = in.u32();
+        Symbol* symbol = new Symbol(name);
+        symbol->is_temp = (flags & 1) != 0;
+        symbol->initial_value = in.str();
+        symbol->size = (int)in.u32();
+        symbol->offset = (int)in.u32();
+        uint32_t type = in.u32();
+        if (type != TYPE_NONE && type >= types.size()) in.ok = false;
+        else if (type != TYPE_NONE) symbol->type = types[type];
+        bool numbered = !name.empty() && name.find_first_not_of("0123456789") == std::string::npos;
+        if (((flags & 2) && !numbered) || !in.ok || !table->insert(name, symbol)) { delete symbol; in.ok = false; break; }
+        if (flags & 2) temps.push_back(symbol);
+    }
+    uint32_t children = in.count(3 * sizeof(uint32_t));
+    if (depth > 1000) in.ok = false;
+    for (uint32_t i = 0; i < children && in.ok; ++i) read_scope(in, table, types, temps, depth + 1);
+    return table;
+}
+
+// Frees a detached tree from read_scope along with the types read for it
+static void discard_scope(SymbolTable* scope, const std::vector<TypeInfo*>& types, const std::vector<Symbol*>& params) {
+    std::vector<SymbolTable*> tables{scope};
+    for (size_t i = 0; i < tables.size(); ++i) {
+        for (const auto& [name, symbol] : tables[i]->symbols) delete symbol;
+        tables[i]->symbols.clear();
+        tables.insert(tables.end(), tables[i]->child_scopes.begin(), tables[i]->child_scopes.end());
+    }
+    for (SymbolTable* table : tables) delete table;
+    std::set<TypeInfo*> owned(types.begin(), types.end());
+    for (Symbol* param : params) if (param) owned.erase(param->type);
+    for (TypeInfo* type : owned) delete type;
+}
+
+static bool load_entry(const std::string& key, const std::vector<Symbol*>& params, std::vector<CachedQuad>& quads,
+                       int& temp_count, SymbolTable*& scope, std::vector<Symbol*>& temps) {
+    std::string data;
+    if (!read_file(cache_entry_path(key), data) || data.size() < sizeof(CACHE_MAGIC) ||
+        memcmp(data.data(), CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0) {
+        return false;
+    }
+    EntryReader in(data);
+    in.pos = sizeof(CACHE_MAGIC);
+    if (in.u32() != CACHE_VERSION || in.str() != key) return false; // Hash collision or stale format
+
+    temp_count = in.u32();
+    uint32_t quad_count = in.u32();
+    quads.clear();
+    quads.reserve(quad_count);
+    for (uint32_t i = 0; i < quad_count && in.ok; ++i) {
+        op_code op = (op_code)in.u32();
+        operand_class type_class = (operand_class)in.u32();
+        uint32_t reloc = in.u32();
+        std::string arg1 = in.str(), arg2 = in.str(), result = in.str();
+        quads.push_back({Quad(op, result, arg1, arg2, type_class), reloc});
+    }
+    std::vector<TypeInfo*> types;
+    if (in.ok && read_types(in, params, types)) {
+        scope = read_scope(in, nullptr, types, temps);
+        if (in.ok && in.pos == data.size()) return true;
+    }
+    if (scope) discard_scope(scope, types, params);
+    else discard_scope(new SymbolTable(), types, params);
+    scope = nullptr;
+    temps.clear();
+    return false;
+}
+
+static void store_entry(const std::string& key, Symbol* func_sym) {
+    // The function occupies quad_list from its FUNC_BEGIN to the FUNC_END just emitted
+    int end = (int)quad_list.size() - 1;
+    int begin = end;
+    while (begin >= 0 && !(quad_list[begin].op == OP_FUNC_BEGIN && quad_list[begin].result == func_sym->name)) --begin;
+    if (begin < 0 || quad_list[end].op != OP_FUNC_END) return;
+    int body_start = quad_base + begin + 1;
+
+    std::set<std::string> temps;
+    SymbolTable* scope = find_function_scope(func_sym->name);
+    if (!scope) return;
+    collect_temp_names(scope, temps);
+    TypeTable types;
+    for (size_t i = 0; i < func_sym->parameters.size(); ++i) {
+        Symbol* param = func_sym->parameters[i];
+        if (param && param->type && !types.param_of.count(param->type)) types.param_of[param->type] = i;
+    }
+    collect_types(scope, types);
+
+    std::string out(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    put_u32(out, CACHE_VERSION);
+    put_str(out, key);
+    put_u32(out, temp_counter - pending_temp_start);
+    put_u32(out, end - begin - 1);
+    for (int i = begin + 1; i < end; ++i) {
+        const Quad& quad = quad_list[i];
+        uint32_t reloc = 0;
+        bool relocated = false;
+        std::string arg1 = relative_temp(quad.arg1, temps, pending_temp_start, relocated);
+        if (relocated) reloc |= RELOC_ARG1_TEMP;
+        std::string arg2 = relative_temp(quad.arg2, temps, pending_temp_start, relocated);
+        if (relocated) reloc |= RELOC_ARG2_TEMP;
+        std::string result;
+        if (is_jump(quad.op) && !quad.result.empty()) {
+            result = std::to_string(std::stoi(quad.result) - body_start);
+            reloc |= RELOC_RESULT_TARGET;
+        } else {
+            result = relative_temp(quad.result, temps, pending_temp_start, relocated);
+            if (relocated) reloc |= RELOC_RESULT_TEMP;
+        }
+        put_u32(out, quad.op);
+        put_u32(out, quad.type_class);
+        put_u32(out, reloc);
+        put_str(out, arg1);
+        put_str(out, arg2);
+        put_str(out, result);
+    }
+    types.write(out);
+    write_scope(out, scope, func_sym->parameters, types, temps, pending_temp_start);
+
+    mkdir(cache_dir.c_str(), 0755); // Fine if it already exists
+    std::string path = cache_entry_path(key);
+    std::string tmp_path = path + ".tmp";
+    FILE* file = fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Warning: Cannot write cache entry " << path << std::endl;
+        return;
+    }
+    bool ok = fwrite(out.data(), 1, out.size(), file) == out.size();
+    fclose(file);
+    if (ok) rename(tmp_path.c_str(), path.c_str()); // Readers never see a partial entry
+    else remove(tmp_path.c_str());
+}
+
+// --- Token layer ---
+static int next_scanned_token(BufferedToken& tok) {
+    line_no = scanner_line_no;
+    {
+        PhaseTimer timer(PHASE_LEX);
+        tok.code = scan_token();
+    }
+    if (tok.code != 0 && stats_enabled) stats_count_token();
+    scanner_line_no = line_no;
+    tok.value = yylval;
+    tok.text = (tok.code != 0 && yytext) ? yytext : "";
+    tok.line = line_no;
+    return tok.code;
+}
+
+static void release_token_value(BufferedToken& tok) {
+    if (tok.code == IDENTIFIER || tok.code == STRING_LITERAL) delete[] tok.value.sval;
+}
+
+// Buffers a function body and decides between replaying it and a cache hit
+static void buffer_function_body() {
+    std::vector<BufferedToken> body;
+    int depth = 1;
+    BufferedToken tok;
+    while (next_scanned_token(tok) != 0) {
+        body.push_back(tok);
+        if (tok.code == BEGIN_TOKEN) depth++;
+        else if (tok.code == END_TOKEN && --depth == 0) break;
+    }
+    if (tok.code == 0) body.push_back(tok); // EOF inside the body: let the parser report it
+
+    if (depth == 0 && current_function) {
+        PhaseTimer timer(PHASE_CACHE);
+        std::string key = build_key(current_function, body);
+        if (load_entry(key, current_function->parameters, hit_quads, hit_temp_count, hit_scope, hit_temps)) {
+            cache_hits++;
+            hit_pending = true;
+            std::cout << "Debug: Cache hit for function '" << current_function->name << "'" << std::endl;
+            for (size_t i = 0; i + 1 < body.size(); ++i) release_token_value(body[i]);
+            replay_queue.push_back(body.back()); // Only the closing END reaches the parser
+            return;
+        }
+        cache_misses++;
+        pending_key = key;
+        pending_temp_start = temp_counter;
+        std::cout << "Debug: Cache miss for function '" << current_function->name << "'" << std::endl;
+    }
+    replay_queue.insert(replay_queue.end(), body.begin(), body.end());
+}
+
+int yylex() {
+    if (!cache_enabled()) {
+        PhaseTimer timer(PHASE_LEX);
+        int code = scan_token();
+        if (code != 0 && stats_enabled) stats_count_token();
+        return code;
+    }
+
+    if (body_next) {
+        body_next = false;
+        buffer_function_body();
+    }
+
+    BufferedToken tok;
+    if (!replay_queue.empty()) {
+        tok = replay_queue.front();
+        replay_queue.pop_front();
+        yylval = tok.value;
+        line_no = tok.line; // Restored before the scanner runs again
+    } else {
+        next_scanned_token(tok);
+    }
+
+    if (tok.code == BEGIN_TOKEN) {
+        if (body_depth == 0) body_next = true;
+        body_depth++;
+    } else if (tok.code == END_TOKEN && body_depth > 0) {
+        body_depth--;
+    }
+    return tok.code;
+}
+
+// Moves the symbols and child scopes of a detached tree into target, re-keying
+// symbols whose names were relocated and fixing levels to the new position
+static void adopt_scope(SymbolTable* target, SymbolTable* detached) {
+    for (const auto& [key, symbol] : detached->symbols) target->insert(symbol->name, symbol);
+    detached->symbols.clear();
+    for (SymbolTable* child : detached->child_scopes) {
+        SymbolTable* table = new SymbolTable(target, target->scope_level + 1, child->scope_name);
+        target->child_scopes.push_back(table);
+        adopt_scope(table, child);
+    }
+    delete detached;
+}
+
+// Called from function_definition before FUNC_END is emitted
+void cache_splice_function() {
+    if (!hit_pending) return;
+    hit_pending = false;
+    PhaseTimer timer(PHASE_CACHE);
+
+    int body_start = get_next_quad_index();
+    int temp_start = temp_counter;
+    for (const CachedQuad& entry : hit_quads) {
+        const Quad& cached = entry.quad;
+        uint32_t reloc = entry.reloc;
+        std::string arg1 = (reloc & RELOC_ARG1_TEMP) ? "t" + std::to_string(temp_start + std::stoi(cached.arg1)) : cached.arg1;
+        std::string arg2 = (reloc & RELOC_ARG2_TEMP) ? "t" + std::to_string(temp_start + std::stoi(cached.arg2)) : cached.arg2;
+        std::string result = cached.result;
+        if (reloc & RELOC_RESULT_TEMP) result = "t" + std::to_string(temp_start + std::stoi(cached.result));
+        else if (reloc & RELOC_RESULT_TARGET) result = std::to_string(body_start + std::stoi(cached.result));
+        emit(cached.op, result, arg1, arg2, cached.type_class);
+    }
+    temp_counter += hit_temp_count;
+    hit_quads.clear();
+
+    // The body's declarations, as its semantic actions would have made them
+    for (Symbol* temp : hit_temps) temp->name = "t" + std::to_string(temp_start + std::stoi(temp->name));
+    hit_temps.clear();
+    SymbolTable* scope = current_function ? find_function_scope(current_function->name) : nullptr;
+    if (scope && hit_scope) adopt_scope(scope, hit_scope);
+    hit_scope = nullptr;
+}
+
+// Called from finalize_function(); stores the function's quads after a miss
+void cache_store_function(Symbol* func_sym) {
+    if (pending_key.empty()) return;
+    PhaseTimer timer(PHASE_CACHE);
+    store_entry(pending_key, func_sym);
+    pending_key.clear();
+}
@@ -0,0 +1,426 @@
+#include "a9_220101003.h"
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+
+// --- TAC Interpreter (--run) ---
+// Executes the generated quads starting at main and writes main's return
+// value and the final value of every global to output/<input>.run. It is a
+// reference for checking that a transformation preserves behaviour: two
+// translations of the same program must produce identical .run files.
+//
+// Values carry their own kind (int, float or pointer) so no type information
+// is needed for temporaries; arithmetic and comparisons dispatch on the quad's
+// operand class and only fall back to the value kinds for untyped quads, and
+// every integer result of an .i8/.i16 quad (arithmetic, moves, stores,
+// returns) is truncated to that width, so an unsound narrowing changes the
+// outcome instead of going unnoticed. Every variable is an object
+// of cells keyed by byte offset; scalars use offset 0 and arrays the offsets
+// computed by the quads themselves, so element sizes never have to be known here.
+
+static const long MAX_STEPS = 50000000;
+static const size_t MAX_CALL_DEPTH = 10000;
+
+struct Object;
+
+struct Value {
+    enum Kind { INT, FLOAT, PTR } kind = INT;
+    long long i = 0;
+    double f = 0.0;
+    std::shared_ptr<Object> obj; // PTR: the object pointed into, at byte offset i
+
+    double as_float() const { return kind == FLOAT ? f : (double)i; }
+    long long as_int() const { return kind == FLOAT ? (long long)f : i; }
+    bool truthy() const { return kind == FLOAT ? f != 0.0 : (kind == PTR ? obj != nullptr : i != 0); }
+};
+
+struct Object {
+    std::map<long long, Value> cells;
+};
+
+struct FunctionInfo {
+    int entry = 0; // Index of the first quad after FUNC_BEGIN
+    Symbol* symbol = nullptr;
+    std::set<std::string> locals; // Names declared anywhere in the function's scope tree
+    std::unordered_map<std::string, TypeInfo*> types;
+};
+
+struct Frame {
+    FunctionInfo* function;
+    std::unordered_map<std::string, std::shared_ptr<Object>> vars;
+    int return_pc;
+    std::string result; // Receives the return value in the caller
+};
+
+struct RuntimeError {
+    std::string message;
+};
+
+// Integer arithmetic wraps like the 4-byte target integer
+static Value make_int(long long v) { Value r; r.i = (int32_t)(uint32_t)v; return r; }
+static Value make_float(double v) { Value r; r.kind = Value::FLOAT; r.f = v; return r; }
+
+// A store of class .i8/.i16 keeps only the low 8/16 bits, as a char or narrowed slot would
+static Value stored_as(const Value& v, operand_class type_class) {
+    if (v.kind != Value::INT) return v;
+    Value r = v;
+    if (type_class == CLASS_I8) r.i = (int8_t)(uint8_t)v.i;
+    else if (type_class == CLASS_I16) r.i = (int16_t)(uint16_t)v.i;
+    return r;
+}
+
+static void collect_names(SymbolTable* table, FunctionInfo& info) {
+    for (const auto& [name, symbol] : table->symbols) {
+        if (!symbol) continue;
+        info.locals.insert(name);
+        info.types.emplace(name, symbol->type); // Outermost declaration wins
+    }
+    for (SymbolTable* child : table->child_scopes) collect_names(child, info);
+}
+
+class Interpreter {
+public:
+    long steps = 0;
+
+    Interpreter() {
+        for (size_t i = 0; i < quad_list.size(); ++i) {
+            const Quad& quad = quad_list[i];
+            if (quad.op != OP_FUNC_BEGIN) continue;
+            FunctionInfo& info = functions[quad.result];
+            info.entry = quad_base + i + 1;
+            info.symbol = global_symbol_table ? global_symbol_table->lookup(quad.result) : nullptr;
+            SymbolTable* scope = find_function_scope(quad.result);
+            if (scope) collect_names(scope, info);
+            if (info.symbol) {
+                for (Symbol* param : info.symbol->parameters) {
+                    if (param) { info.locals.insert(param->name); info.types.emplace(param->name, param->type); }
+                }
+            }
+        }
+    }
+
+    Value run_main() {
+        run_global_initialisers();
+        auto it = functions.find("main");
+        if (it == functions.end()) throw RuntimeError{"no function 'main'"};
+        Value result;
+        int pc = call(it->second, {}, -1, "");
+        while (pc >= 0) pc = step(pc, result);
+        return result;
+    }
+
+    std::shared_ptr<Object> global_object(const std::string& name) {
+        auto it = globals.find(name);
+        return it == globals.end() ? nullptr : it->second;
+    }
+
+private:
+    std::unordered_map<std::string, FunctionInfo> functions;
+    std::unordered_map<std::string, std::shared_ptr<Object>> globals;
+    std::vector<Frame> frames;
+    std::vector<Value> params;
+
+    // Quads outside any function (global initialisers) run once, in order, before main
+    void run_global_initialisers() {
+        FunctionInfo top_level; // No locals: every name is a global
+        frames.push_back(Frame{&top_level, {}, -1, ""});
+        Value unused;
+        int end = quad_base + (int)quad_list.size();
+        for (int pc = quad_base; pc < end;) {
+            const Quad& q = quad_at(pc);
+            if (q.op == OP_FUNC_BEGIN) {
+                while (pc < end && !(quad_at(pc).op == OP_FUNC_END && quad_at(pc).result == q.result)) pc++;
+                pc++;
+                continue;
+            }
+            pc = step(pc, unused);
+            while (frames.size() > 1) pc = step(pc, unused); // A call made by an initialiser
+        }
+        frames.pop_back();
+    }
+
+    const Quad& quad_at(int pc) {
+        int local = pc - quad_base;
+        if (local < 0 || local >= (int)quad_list.size()) throw RuntimeError{"jump to invalid quad " + std::to_string(pc)};
+        return quad_list[local];
+    }
+
+    TypeInfo* type_of(const std::string& name) {
+        if (!frames.empty()) {
+            auto& types = frames.back().function->types;
+            auto it = types.find(name);
+            if (it != types.end()) return it->second;
+        }
+        Symbol* sym = global_symbol_table ? global_symbol_table->lookup(name) : nullptr;
+        return sym ? sym->type : nullptr;
+    }
+
+    std::shared_ptr<Object>& resolve(const std::string& name) {
+        Frame& frame = frames.back();
+        bool global = !frame.function->locals.count(name) && global_symbol_table && global_symbol_table->lookup(name);
+        auto& table = global ? globals : frame.vars;
+        std::shared_ptr<Object>& obj = table[name];
+        if (!obj) obj = std::make_shared<Object>();
+        return obj;
+    }
+
+    static bool is_literal(const std::string& s) {
+        if (s.empty()) return false;
+        char c = s[0];
+        if (c == '-' || c == '+' || c == '.') return s.size() > 1 && (isdigit((unsigned char)s[1]) || s[1] == '.');
+        return isdigit((unsigned char)c);
+    }
+
+    Value eval(const std::string& operand) {
+        if (operand.empty()) return Value();
+        if (is_literal(operand)) {
+            if (operand.find_first_of(".eE") != std::string::npos) return make_float(strtod(operand.c_str(), nullptr));
+            return make_int(strtoll(operand.c_str(), nullptr, 10));
+        }
+        std::shared_ptr<Object>& obj = resolve(operand);
+        TypeInfo* type = type_of(operand);
+        if (type && type->base == TYPE_ARRAY) { // An array name decays to a pointer to its first element
+            Value ptr;
+            ptr.kind = Value::PTR;
+            ptr.obj = obj;
+            return ptr;
+        }
+        return obj->cells[0];
+    }
+
+    void store(const std::string& name, const Value& v) { resolve(name)->cells[0] = v; }
+
+    Value& deref(const Value& ptr, long long extra) {
+        if (ptr.kind != Value::PTR || !ptr.obj) throw RuntimeError{"dereference of a non-pointer value"};
+        return ptr.obj->cells[ptr.i + extra];
+    }
+
+    // a[offset] where a is either an array object or a pointer (array parameter)
+    Value& element(const std::string& name, const Value& offset) {
+        TypeInfo* type = type_of(name);
+        std::shared_ptr<Object>& obj = resolve(name);
+        if (type && type->base == TYPE_POINTER) return deref(obj->cells[0], offset.as_int());
+        return obj->cells[offset.as_int()];
+    }
+
+    static Value arithmetic(op_code op, operand_class type_class, const Value& a, const Value& b) {
+        if (a.kind == Value::PTR || b.kind == Value::PTR) { // Pointer +/- byte offset
+            const Value& ptr = a.kind == Value::PTR ? a : b;
+            const Value& off = a.kind == Value::PTR ? b : a;
+            if (op != OP_PLUS && op != OP_MINUS) throw RuntimeError{"invalid pointer arithmetic"};
+            Value r = ptr;
+            r.i += op == OP_PLUS ? off.as_int() : -off.as_int();
+            return r;
+        }
+        bool is_float = type_class == CLASS_NONE ? (a.kind == Value::FLOAT || b.kind == Value::FLOAT) : type_class == CLASS_F64;
+        if (is_float) {
+            double x = a.as_float(), y = b.as_float();
+            switch (op) {
+                case OP_PLUS: return make_float(x + y);
+                case OP_MINUS: return make_float(x - y);
+                case OP_MULT: return make_float(x * y);
+                case OP_DIV: if (y == 0.0) throw RuntimeError{"division by zero"}; return make_float(x / y);
+                default: throw RuntimeError{"invalid float operation " + opcode_to_string(op)};
+            }
+        }
+        long long x = a.as_int(), y = b.as_int();
+        switch (op) {
+            case OP_PLUS: return make_int(x + y);
+            case OP_MINUS: return make_int(x - y);
+            case OP_MULT: return make_int(x * y);
+            case OP_DIV: if (y == 0) throw RuntimeError{"division by zero"}; return make_int(x / y);
+            case OP_MOD: if (y == 0) throw RuntimeError{"division by zero"}; return make_int(x % y);
+            default: throw RuntimeError{"invalid integer operation " + opcode_to_string(op)};
+        }
+    }
+
+    template <typename T>
+    static bool compare_as(op_code op, T x, T y) {
+        switch (op) {
+            case OP_LT: case OP_IF_LT: return x < y;
+            case OP_GT: case OP_IF_GT: return x > y;
+            case OP_LE: case OP_IF_LE: return x <= y;
+            case OP_GE: case OP_IF_GE: return x >= y;
+            case OP_EQ: case OP_IF_EQ: return x == y;
+            default: return x != y;
+        }
+    }
+
+    static bool compare(op_code op, operand_class type_class, const Value& a, const Value& b) {
+        if (a.kind == Value::PTR || b.kind == Value::PTR) {
+            bool same = a.obj == b.obj && a.i == b.i;
+            if (op == OP_EQ || op == OP_IF_EQ) return same;
+            if (op == OP_NE || op == OP_IF_NE) return !same;
+            throw RuntimeError{"ordered comparison of pointers"};
+        }
+        if (type_class == CLASS_I8 || type_class == CLASS_I16 || type_class == CLASS_I32) return compare_as(op, a.as_int(), b.as_int());
+        if (type_class == CLASS_NONE && a.kind == Value::INT && b.kind == Value::INT) return compare_as(op, a.i, b.i);
+        return compare_as(op, a.as_float(), b.as_float());
+    }
+
+    // Pushes a frame and returns the callee's entry point
+    int call(FunctionInfo& function, std::vector<Value> args, int return_pc, const std::string& result) {
+        if (frames.size() >= MAX_CALL_DEPTH) throw RuntimeError{"call depth limit exceeded"};
+        frames.push_back(Frame{&function, {}, return_pc, result});
+        if (function.symbol) {
+            const auto& formals = function.symbol->parameters;
+            for (size_t i = 0; i < formals.size() && i < args.size(); ++i) {
+                if (formals[i]) store(formals[i]->name, args[i]);
+            }
+        }
+        return function.entry;
+    }
+
+    int do_return(const Value& value, Value& main_result) {
+        Frame frame = std::move(frames.back());
+        frames.pop_back();
+        if (frames.empty()) {
+            main_result = value;
+            return -1;
+        }
+        if (!frame.result.empty()) store(frame.result, value);
+        return frame.return_pc;
+    }
+
+    int step(int pc, Value& main_result) {
+        if (++steps > MAX_STEPS) throw RuntimeError{"step limit exceeded"};
+        const Quad& q = quad_at(pc);
+        int next = pc + 1;
+        switch (q.op) {
+            case OP_PLUS: case OP_MINUS: case OP_MULT: case OP_DIV: case OP_MOD:
+                store(q.result, stored_as(arithmetic(q.op, q.type_class, eval(q.arg1), eval(q.arg2)), q.type_class));
+                break;
+            case OP_UMINUS: {
+                Value v = eval(q.arg1);
+                bool is_float = q.type_class == CLASS_NONE ? v.kind == Value::FLOAT : q.type_class == CLASS_F64;
+                store(q.result, stored_as(is_float ? make_float(-v.as_float()) : make_int(-v.as_int()), q.type_class));
+                break;
+            }
+            case OP_UPLUS: store(q.result, stored_as(eval(q.arg1), q.type_class)); break;
+            case OP_NOT: store(q.result, make_int(!eval(q.arg1).truthy())); break;
+            case OP_LT: case OP_GT: case OP_LE: case OP_GE: case OP_EQ: case OP_NE:
+                store(q.result, make_int(compare(q.op, q.type_class, eval(q.arg1), eval(q.arg2))));
+                break;
+            case OP_AND: store(q.result, make_int(eval(q.arg1).truthy() && eval(q.arg2).truthy())); break;
+            case OP_OR: store(q.result, make_int(eval(q.arg1).truthy() || eval(q.arg2).truthy())); break;
+            case OP_ASSIGN: store(q.result, stored_as(eval(q.arg1), q.type_class)); break;
+            case OP_GOTO: next = std::stoi(q.result); break;
+            case OP_IF_FALSE: if (!eval(q.arg1).truthy()) next = std::stoi(q.result); break;
+            case OP_IF_TRUE: if (eval(q.arg1).truthy()) next = std::stoi(q.result); break;
+            case OP_IF_LT: case OP_IF_GT: case OP_IF_LE: case OP_IF_GE: case OP_IF_EQ: case OP_IF_NE:
+                if (compare(q.op, q.type_class, eval(q.arg1), eval(q.arg2))) next = std::stoi(q.result);
+                break;
+            case OP_PARAM: params.push_back(eval(q.result)); break;
+            case OP_CALL: {
+                auto it = functions.find(q.arg1);
+                if (it == functions.end()) throw RuntimeError{"call to undefined function '" + q.arg1 + "'"};
+                size_t count = q.arg2.empty() ? 0 : std::stoul(q.arg2);
+                if (count > params.size()) throw RuntimeError{"missing parameters for '" + q.arg1 + "'"};
+                std::vector<Value> args(params.end() - count, params.end());
+                params.resize(params.size() - count);
+                next = call(it->second, std::move(args), next, q.result);
+                break;
+            }
+            case OP_TAILCALL: { // The callee takes over this frame's return address and result
+                auto it = functions.find(q.arg1);
+                if (it == functions.end()) throw RuntimeError{"call to undefined function '" + q.arg1 + "'"};
+                size_t count = q.arg2.empty() ? 0 : std::stoul(q.arg2);
+                if (count > params.size()) throw RuntimeError{"missing parameters for '" + q.arg1 + "'"};
+                std::vector<Value> args(params.end() - count, params.end());
+                params.resize(params.size() - count);
+                Frame frame = std::move(frames.back());
+                frames.pop_back();
+                next = call(it->second, std::move(args), frame.return_pc, frame.result);
+                break;
+            }
+            case OP_RETURN: next = do_return(q.result.empty() ? Value() : stored_as(eval(q.result), q.type_class), main_result); break;
+            case OP_FUNC_END: next = do_return(Value(), main_result); break;
+            case OP_FUNC_BEGIN: break;
+            case OP_ADDR: {
+                Value ptr;
+                ptr.kind = Value::PTR;
+                ptr.obj = resolve(q.arg1);
+                store(q.result, ptr);
+                break;
+            }
+            case OP_DEREF_ASSIGN: deref(eval(q.result), 0) = stored_as(eval(q.arg1), q.type_class); break;
+            case OP_ASSIGN_DEREF: store(q.result, deref(eval(q.arg1), 0)); break;
+            case OP_ARRAY_ACCESS: store(q.result, element(q.arg1, eval(q.arg2))); break;
+            case OP_ARRAY_ASSIGN: {
+                Value v = stored_as(eval(q.arg2), q.type_class);
+                element(q.result, eval(q.arg1)) = v;
+                break;
+            }
+            case OP_BLOCK_FILL: case OP_BLOCK_COPY: { // Element by element, in increasing order
+                Value dst = eval(q.result);
+                Value src = eval(q.arg1);
+                long long size = class_size(q.type_class);
+                long long bytes = q.arg2.empty() ? 0 : std::stoll(q.arg2);
+                if (size <= 0) throw RuntimeError{"untyped block operation"};
+                if (q.op == OP_BLOCK_FILL) src = stored_as(src, q.type_class);
+                for (long long offset = 0; offset < bytes; offset += size) {
+                    deref(dst, offset) = q.op == OP_BLOCK_FILL ? src : deref(src, offset);
+                }
+                break;
+            }
+            case OP_INT2FLOAT: store(q.result, make_float(eval(q.arg1).as_float())); break;
+            case OP_FLOAT2INT: store(q.result, make_int(eval(q.arg1).as_int())); break;
+            default: throw RuntimeError{"unsupported opcode " + opcode_to_string(q.op)};
+        }
+        return next;
+    }
+};
+
+// Prints a value as its declared type so int/float representation choices do not matter
+static std::string format_value(const Value& v, TypeInfo* type) {
+    if (v.kind == Value::PTR) return "<pointer>";
+    char buf[64];
+    if (type && type->base == TYPE_FLOAT) snprintf(buf, sizeof(buf), "%.6f", v.as_float());
+    else if (type && type->base == TYPE_BOOL) snprintf(buf, sizeof(buf), "%d", v.truthy() ? 1 : 0);
+    else snprintf(buf, sizeof(buf), "%lld", v.as_int());
+    return buf;
+}
+
+bool run_program(const std::string& filename) {
+    std::ofstream out(filename);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not open run output file: " << filename << std::endl;
+        return false;
+    }
+
+    Interpreter interp;
+    bool ok = true;
+    try {
+        Value result = interp.run_main();
+        Symbol* main_sym = global_symbol_table ? global_symbol_table->lookup("main") : nullptr;
+        TypeInfo* ret_type = main_sym && main_sym->type ? main_sym->type->return_type : nullptr;
+        out << "main returned " << format_value(result, ret_type) << "\n";
+    } catch (const RuntimeError& err) {
+        out << "runtime error: " << err.message << "\n";
+        ok = false;
+    }
+
+    // Final state of the globals
+    for (const auto& [name, symbol] : global_symbol_table->symbols) {
+        if (!symbol || symbol->is_temp || !symbol->type || symbol->type->base == TYPE_FUNCTION) continue;
+        std::shared_ptr<Object> obj = interp.global_object(name);
+        if (symbol->type->base == TYPE_ARRAY) {
+            TypeInfo* elem = symbol->type->ptr_type;
+            int width = elem && elem->width > 0 ? elem->width : 1;
+            if (!obj) continue;
+            for (const auto& [offset, value] : obj->cells) {
+                out << name << "[" << offset / width << "] = " << format_value(value, elem) << "\n";
+            }
+        } else {
+            out << name << " = " << format_value(obj ? obj->cells[0] : Value(), symbol->type) << "\n";
+        }
+    }
+
+    std::cout << "Program executed " << interp.steps << " quads; results written to " << filename << std::endl;
+    return ok;
+}
@@ -0,0 +1,529 @@
+#include "a9_220101003.h"
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <algorithm>
+#include <fcntl.h>    // open()
+#include <sys/mman.h> // mmap()
+#include <sys/stat.h> // fstat()
+#include <unistd.h>   // close()
+
+// --- Binary IR Container ---
+// Layout (all sections 8-byte aligned, offsets in the header, host byte order):
+//   IRHeader | IRQuad[] | IRType[] | IRSymbol[] | IRScope[] | uint32_t index pool | string pool
+// Every record is fixed-size POD, and strings are offsets into a NUL-terminated
+// pool, so a loaded file is usable in place: no per-field parsing is needed.
+
+static const char IR_MAGIC[4] = {'M', 'C', 'I', 'R'};
+static const uint32_t IR_VERSION = 2;
+static const uint32_t IR_BYTE_ORDER_MARK = 0x01020304;
+static const uint32_t IR_NONE = 0xFFFFFFFFu;
+static const uint32_t IR_SYM_TEMP = 1u;
+
+struct IRHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t quad_count;
+    uint32_t type_count;
+    uint32_t symbol_count;
+    uint32_t scope_count;
+    uint32_t index_count;
+    uint32_t string_bytes;
+    uint32_t first_quad_index; // Absolute index of the first quad
+    uint64_t quad_offset;
+    uint64_t type_offset;
+    uint64_t symbol_offset;
+    uint64_t scope_offset;
+    uint64_t index_offset;
+    uint64_t string_offset;
+};
+
+struct IRQuad {
+    uint32_t op;
+    uint32_t arg1;   // String pool offsets (0 is the empty string)
+    uint32_t arg2;
+    uint32_t result;
+    uint32_t type_class; // operand_class
+};
+
+struct IRType {
+    int32_t base;
+    int32_t width;
+    uint32_t ptr_type;    // Type index or IR_NONE
+    uint32_t return_type; // Type index or IR_NONE
+    uint32_t first_dim;   // Index pool slice holding the dimensions
+    uint32_t dim_count;
+    uint32_t first_param; // Index pool slice holding parameter type indices
+    uint32_t param_count;
+};
+
+struct IRSymbol {
+    uint32_t name;
+    uint32_t type;          // Type index or IR_NONE
+    uint32_t initial_value;
+    int32_t size;
+    int32_t offset;
+    uint32_t flags;
+    uint32_t nested_table;  // Scope index or IR_NONE
+    uint32_t first_param;   // Index pool slice holding parameter symbol indices
+    uint32_t param_count;
+};
+
+struct IRScope {
+    uint32_t name;
+    uint32_t parent;        // Scope index or IR_NONE (global scope)
+    int32_t level;
+    uint32_t first_symbol;  // Symbols of a scope are stored contiguously
+    uint32_t symbol_count;
+};
+
+// --- Writer ---
+// Records are collected as the program is translated. In --stream mode each
+// function's quads and scope tree are recorded just before they are freed.
+// Scope 0 is always the global scope; its symbols are recorded last so that the
+// parameter symbols of every function are already indexed.
+bool emit_ir_mode = false;
+
+struct IRWriter {
+    std::vector<IRQuad> quads;
+    std::vector<IRType> types;
+    std::vector<IRSymbol> symbols;
+    std::vector<IRScope> scopes;
+    std::vector<uint32_t> indices;
+    std::string strings;
+    std::unordered_map<std::string, uint32_t> string_ids;
+    std::unordered_map<const TypeInfo*, uint32_t> type_ids;
+    std::unordered_map<const Symbol*, uint32_t> symbol_ids;
+    std::unordered_map<const SymbolTable*, uint32_t> scope_ids;
+    std::unordered_map<std::string, std::vector<uint32_t>> function_params; // Captured before scopes are freed
+    std::vector<std::pair<uint32_t, const SymbolTable*>> nested_refs;
+    bool started = false;
+    uint32_t first_quad_index = 0;
+
+    void start() {
+        if (started) return;
+        started = true;
+        strings.assign(1, '\0');
+        scopes.push_back(IRScope{0, IR_NONE, 0, 0, 0}); // Reserved for the global scope
+    }
+
+    uint32_t add_string(const std::string& s) {
+        if (s.empty()) return 0;
+        auto it = string_ids.find(s);
+        if (it != string_ids.end()) return it->second;
+        uint32_t id = strings.size();
+        strings.append(s);
+        strings.push_back('\0');
+        string_ids.emplace(s, id);
+        return id;
+    }
+
+    uint32_t add_type(const TypeInfo* type) {
+        if (!type) return IR_NONE;
+        auto it = type_ids.find(type);
+        if (it != type_ids.end()) return it->second;
+        uint32_t id = types.size();
+        type_ids.emplace(type, id);
+        types.push_back(IRType{});
+
+        IRType rec{};
+        rec.base = type->base;
+        rec.width = type->width;
+        rec.ptr_type = add_type(type->ptr_type);
+        rec.return_type = add_type(type->return_type);
+        std::vector<uint32_t> param_ids;
+        for (const TypeInfo* param_type : type->param_types) param_ids.push_back(add_type(param_type));
+        rec.first_dim = indices.size();
+        rec.dim_count = type->dims.size();
+        for (int dim : type->dims) indices.push_back((uint32_t)dim);
+        rec.first_param = indices.size();
+        rec.param_count = param_ids.size();
+        indices.insert(indices.end(), param_ids.begin(), param_ids.end());
+        types[id] = rec;
+        return id;
+    }
+
+    uint32_t add_symbol(const Symbol* symbol) {
+        uint32_t id = symbols.size();
+        symbol_ids[symbol] = id;
+        IRSymbol rec{};
+        rec.name = add_string(symbol->name);
+        rec.type = add_type(symbol->type);
+        rec.initial_value = add_string(symbol->initial_value);
+        rec.size = symbol->size;
+        rec.offset = symbol->offset;
+        rec.flags = symbol->is_temp ? IR_SYM_TEMP : 0;
+        rec.nested_table = IR_NONE; // Patched once the scope it names has an index
+        if (symbol->nested_table) nested_refs.emplace_back(id, symbol->nested_table);
+        rec.first_param = 0;
+        rec.param_count = 0;
+        symbols.push_back(rec);
+        return id;
+    }
+
+    void add_scope_symbols(const SymbolTable* table, IRScope& rec) {
+        rec.first_symbol = symbols.size();
+        rec.symbol_count = 0;
+        for (const auto& [name, symbol] : table->symbols) {
+            if (!symbol) continue;
+            add_symbol(symbol);
+            rec.symbol_count++;
+        }
+    }
+
+    void add_scope_tree(const SymbolTable* table, uint32_t parent_id) {
+        uint32_t id = scopes.size();
+        scope_ids[table] = id;
+        IRScope rec{};
+        rec.name = add_string(table->scope_name);
+        rec.parent = parent_id;
+        rec.level = table->scope_level;
+        add_scope_symbols(table, rec);
+        scopes.push_back(rec);
+        for (const SymbolTable* child : table->child_scopes) add_scope_tree(child, id);
+    }
+
+    void resolve_nested_refs() {
+        for (const auto& [symbol_id, table] : nested_refs) {
+            auto it = scope_ids.find(table);
+            if (it != scope_ids.end()) symbols[symbol_id].nested_table = it->second;
+        }
+        nested_refs.clear();
+    }
+
+    // Drops the pointer keys of a scope tree that is about to be freed, so a
+    // later allocation at the same address is not mistaken for it.
+    void forget_scope_tree(const SymbolTable* table) {
+        scope_ids.erase(table);
+        for (const auto& [name, symbol] : table->symbols) {
+            if (!symbol) continue;
+            symbol_ids.erase(symbol);
+            type_ids.erase(symbol->type);
+        }
+        for (const SymbolTable* child : table->child_scopes) forget_scope_tree(child);
+    }
+};
+
+static IRWriter ir_writer;
+
+void ir_record_quads(const std::vector<Quad>& quads, int first_index) {
+    ir_writer.start();
+    if (ir_writer.quads.empty()) ir_writer.first_quad_index = first_index;
+    for (const Quad& quad : quads) {
+        ir_writer.quads.push_back(IRQuad{(uint32_t)quad.op, ir_writer.add_string(quad.arg1),
+                                         ir_writer.add_string(quad.arg2), ir_writer.add_string(quad.result),
+                                         (uint32_t)quad.type_class});
+    }
+}
+
+void ir_record_function_scope(SymbolTable* scope, Symbol* func_sym, bool releasing) {
+    if (!scope) return;
+    ir_writer.start();
+    ir_writer.add_scope_tree(scope, 0);
+    if (func_sym) {
+        std::vector<uint32_t>& params = ir_writer.function_params[func_sym->name];
+        params.clear();
+        for (Symbol* param : func_sym->parameters) {
+            auto it = ir_writer.symbol_ids.find(param);
+            if (it != ir_writer.symbol_ids.end()) params.push_back(it->second);
+        }
+    }
+    if (releasing) {
+        ir_writer.resolve_nested_refs();
+        ir_writer.forget_scope_tree(scope);
+    }
+}
+
+static void ir_record_global_scope() {
+    // Child scopes still attached to the global table (all of them outside --stream mode)
+    for (SymbolTable* child : global_symbol_table->child_scopes) {
+        Symbol* func_sym = global_symbol_table->lookup(child->scope_name);
+        bool is_function = func_sym && func_sym->type && func_sym->type->base == TYPE_FUNCTION;
+        ir_record_function_scope(child, is_function ? func_sym : nullptr, false);
+    }
+
+    IRScope& global_rec = ir_writer.scopes[0];
+    global_rec.name = ir_writer.add_string(global_symbol_table->scope_name);
+    global_rec.parent = IR_NONE;
+    global_rec.level = global_symbol_table->scope_level;
+    ir_writer.scope_ids[global_symbol_table] = 0;
+    IRScope rec = global_rec;
+    ir_writer.add_scope_symbols(global_symbol_table, rec);
+    ir_writer.scopes[0] = rec;
+
+    // Function parameter lists
+    for (uint32_t i = rec.first_symbol; i < rec.first_symbol + rec.symbol_count; ++i) {
+        const char* name = ir_writer.strings.c_str() + ir_writer.symbols[i].name;
+        auto it = ir_writer.function_params.find(name);
+        if (it == ir_writer.function_params.end()) continue;
+        ir_writer.symbols[i].first_param = ir_writer.indices.size();
+        ir_writer.symbols[i].param_count = it->second.size();
+        ir_writer.indices.insert(ir_writer.indices.end(), it->second.begin(), it->second.end());
+    }
+}
+
+static uint64_t align8(uint64_t n) { return (n + 7) & ~uint64_t(7); }
+
+bool write_ir_file(const std::string& filename) {
+    ir_writer.start();
+    if (!quad_list.empty()) ir_record_quads(quad_list, quad_base);
+    if (global_symbol_table) ir_record_global_scope();
+
+    ir_writer.resolve_nested_refs(); // Every remaining scope has an index now
+
+    IRHeader header{};
+    memcpy(header.magic, IR_MAGIC, sizeof(IR_MAGIC));
+    header.version = IR_VERSION;
+    header.byte_order = IR_BYTE_ORDER_MARK;
+    header.quad_count = ir_writer.quads.size();
+    header.type_count = ir_writer.types.size();
+    header.symbol_count = ir_writer.symbols.size();
+    header.scope_count = ir_writer.scopes.size();
+    header.index_count = ir_writer.indices.size();
+    header.string_bytes = ir_writer.strings.size();
+    header.first_quad_index = ir_writer.first_quad_index;
+    header.quad_offset = align8(sizeof(IRHeader));
+    header.type_offset = align8(header.quad_offset + sizeof(IRQuad) * header.quad_count);
+    header.symbol_offset = align8(header.type_offset + sizeof(IRType) * header.type_count);
+    header.scope_offset = align8(header.symbol_offset + sizeof(IRSymbol) * header.symbol_count);
+    header.index_offset = align8(header.scope_offset + sizeof(IRScope) * header.scope_count);
+    header.string_offset = align8(header.index_offset + sizeof(uint32_t) * header.index_count);
+    uint64_t total = header.string_offset + header.string_bytes;
+
+    std::string image(total, '\0');
+    memcpy(&image[0], &header, sizeof(header));
+    auto put_section = [&image](uint64_t offset, const void* data, size_t bytes) {
+        if (bytes) memcpy(&image[offset], data, bytes); // An empty vector's data() may be null
+    };
+    put_section(header.quad_offset, ir_writer.quads.data(), sizeof(IRQuad) * header.quad_count);
+    put_section(header.type_offset, ir_writer.types.data(), sizeof(IRType) * header.type_count);
+    put_section(header.symbol_offset, ir_writer.symbols.data(), sizeof(IRSymbol) * header.symbol_count);
+    put_section(header.scope_offset, ir_writer.scopes.data(), sizeof(IRScope) * header.scope_count);
+    put_section(header.index_offset, ir_writer.indices.data(), sizeof(uint32_t) * header.index_count);
+    put_section(header.string_offset, ir_writer.strings.data(), header.string_bytes);
+
+    FILE* out = fopen(filename.c_str(), "wb");
+    if (!out) {
+        std::cerr << "Error: Could not open IR output file: " << filename << std::endl;
+        return false;
+    }
+    bool ok = fwrite(image.data(), 1, image.size(), out) == image.size();
+    fclose(out);
+    if (!ok) {
+        std::cerr << "Error: Failed writing IR file: " << filename << std::endl;
+        return false;
+    }
+    std::cout << "Binary IR written to " << filename << " (" << header.quad_count << " quads, "
+              << header.symbol_count << " symbols, " << total << " bytes)" << std::endl;
+    ir_writer = IRWriter();
+    return true;
+}
+
+// --- Validation ---
+// Everything the loader dereferences is checked first, so a truncated or
+// corrupt file is rejected instead of being read outside the mapping.
+
+static bool section_fits(uint64_t offset, uint64_t count, uint64_t record_size, size_t file_size) {
+    return offset % 8 == 0 && offset <= file_size && count * record_size <= file_size - offset;
+}
+
+static bool slice_fits(uint32_t first, uint32_t count, uint32_t total) {
+    return (uint64_t)first + count <= total;
+}
+
+// Returns what is wrong with the file, or "" if the loader may use it
+static std::string ir_file_error(const char* base, size_t file_size) {
+    const IRHeader* header = reinterpret_cast<const IRHeader*>(base);
+    if (!section_fits(header->quad_offset, header->quad_count, sizeof(IRQuad), file_size)) return "quad section out of bounds";
+    if (!section_fits(header->type_offset, header->type_count, sizeof(IRType), file_size)) return "type section out of bounds";
+    if (!section_fits(header->symbol_offset, header->symbol_count, sizeof(IRSymbol), file_size)) return "symbol section out of bounds";
+    if (!section_fits(header->scope_offset, header->scope_count, sizeof(IRScope), file_size)) return "scope section out of bounds";
+    if (!section_fits(header->index_offset, header->index_count, sizeof(uint32_t), file_size)) return "index pool out of bounds";
+    if (header->string_offset > file_size || header->string_bytes > file_size - header->string_offset) return "string pool out of bounds";
+    if (header->string_bytes == 0 || base[header->string_offset + header->string_bytes - 1] != '\0') return "string pool is not NUL-terminated";
+    if ((uint64_t)header->first_quad_index + header->quad_count > INT32_MAX) return "quad index out of range";
+
+    const IRQuad* quads = reinterpret_cast<const IRQuad*>(base + header->quad_offset);
+    const IRType* types = reinterpret_cast<const IRType*>(base + header->type_offset);
+    const IRSymbol* symbols = reinterpret_cast<const IRSymbol*>(base + header->symbol_offset);
+    const IRScope* scopes = reinterpret_cast<const IRScope*>(base + header->scope_offset);
+    const uint32_t* indices = reinterpret_cast<const uint32_t*>(base + header->index_offset);
+    auto is_string = [&](uint32_t offset) { return offset < header->string_bytes; };
+    auto is_type = [&](uint32_t index) { return index == IR_NONE || index < header->type_count; };
+
+    for (uint32_t i = 0; i < header->quad_count; ++i) {
+        const IRQuad& rec = quads[i];
+        if (rec.op > OP_TAILCALL || rec.type_class > CLASS_I16) return "quad " + std::to_string(i) + " has an unknown opcode or class";
+        if (!is_string(rec.arg1) || !is_string(rec.arg2) || !is_string(rec.result)) return "quad " + std::to_string(i) + " names a string outside the pool";
+    }
+
+    // Types must reference existing types without cycles (TypeInfo is walked recursively)
+    std::vector<uint32_t> referrers(header->type_count, 0);
+    std::vector<std::vector<uint32_t>> referenced(header->type_count);
+    for (uint32_t i = 0; i < header->type_count; ++i) {
+        const IRType& rec = types[i];
+        std::string where = "type " + std::to_string(i);
+        if (rec.base < TYPE_VOID || rec.base > TYPE_UNKNOWN) return where + " has an unknown base type";
+        if (!is_type(rec.ptr_type) || !is_type(rec.return_type)) return where + " references a missing type";
+        if (!slice_fits(rec.first_dim, rec.dim_count, header->index_count) ||
+            !slice_fits(rec.first_param, rec.param_count, header->index_count)) return where + " has a slice outside the index pool";
+        if (rec.ptr_type != IR_NONE) referenced[i].push_back(rec.ptr_type);
+        if (rec.return_type != IR_NONE) referenced[i].push_back(rec.return_type);
+        for (uint32_t p = 0; p < rec.param_count; ++p) {
+            uint32_t param = indices[rec.first_param + p];
+            if (param >= header->type_count) return where + " has a missing parameter type";
+            referenced[i].push_back(param);
+        }
+        for (uint32_t target : referenced[i]) referrers[target]++;
+    }
+    std::vector<uint32_t> unreferenced;
+    for (uint32_t i = 0; i < header->type_count; ++i) if (referrers[i] == 0) unreferenced.push_back(i);
+    uint32_t ordered = 0;
+    while (!unreferenced.empty()) {
+        uint32_t i = unreferenced.back();
+        unreferenced.pop_back();
+        ordered++;
+        for (uint32_t target : referenced[i]) if (--referrers[target] == 0) unreferenced.push_back(target);
+    }
+    if (ordered != header->type_count) return "types form a cycle";
+
+    // Each symbol belongs to at most one scope, and a scope's parent comes before it
+    std::vector<bool> owned(header->symbol_count, false);
+    for (uint32_t i = 0; i < header->scope_count; ++i) {
+        const IRScope& rec = scopes[i];
+        std::string where = "scope " + std::to_string(i);
+        if (!is_string(rec.name)) return where + " names a string outside the pool";
+        if (rec.parent != IR_NONE && rec.parent >= i) return where + " has an invalid parent";
+        if (!slice_fits(rec.first_symbol, rec.symbol_count, header->symbol_count)) return where + " has symbols outside the symbol section";
+        for (uint32_t s = rec.first_symbol; s < rec.first_symbol + rec.symbol_count; ++s) {
+            if (owned[s]) return "symbol " + std::to_string(s) + " belongs to two scopes";
+            owned[s] = true;
+        }
+    }
+    for (uint32_t s = 0; s < header->symbol_count; ++s) {
+        const IRSymbol& rec = symbols[s];
+        std::string where = "symbol " + std::to_string(s);
+        if (!is_string(rec.name) || !is_string(rec.initial_value)) return where + " names a string outside the pool";
+        if (!is_type(rec.type)) return where + " references a missing type";
+        if (rec.nested_table != IR_NONE && rec.nested_table >= header->scope_count) return where + " references a missing scope";
+        if (!slice_fits(rec.first_param, rec.param_count, header->index_count)) return where + " has a slice outside the index pool";
+        for (uint32_t p = 0; p < rec.param_count; ++p) {
+            uint32_t param = indices[rec.first_param + p];
+            if (param >= header->symbol_count || !owned[param]) return where + " has a missing parameter symbol";
+        }
+    }
+    return "";
+}
+
+// --- Loader ---
+// The file is mapped read-only and the fixed-size records are read in place.
+// The translator's own structures (quad_list, SymbolTable tree, TypeInfo) are
+// then rebuilt from them so every later stage works unchanged.
+bool load_ir_file(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot open IR file: " << filename << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(IRHeader)) {
+        std::cerr << "Error: IR file is truncated: " << filename << std::endl;
+        close(fd);
+        return false;
+    }
+    size_t file_size = st.st_size;
+    void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Error: Cannot map IR file: " << filename << std::endl;
+        return false;
+    }
+
+    const char* base = static_cast<const char*>(mapping);
+    const IRHeader* header = reinterpret_cast<const IRHeader*>(base);
+    if (memcmp(header->magic, IR_MAGIC, sizeof(IR_MAGIC)) != 0 || header->version != IR_VERSION ||
+        header->byte_order != IR_BYTE_ORDER_MARK) {
+        std::cerr << "Error: Not a compatible microC IR file: " << filename << std::endl;
+        munmap(mapping, file_size);
+        return false;
+    }
+    std::string problem = ir_file_error(base, file_size);
+    if (!problem.empty()) {
+        std::cerr << "Error: Corrupt IR file: " << filename << " (" << problem << ")" << std::endl;
+        munmap(mapping, file_size);
+        return false;
+    }
+
+    const IRQuad* quads = reinterpret_cast<const IRQuad*>(base + header->quad_offset);
+    const IRType* types = reinterpret_cast<const IRType*>(base + header->type_offset);
+    const IRSymbol* symbols = reinterpret_cast<const IRSymbol*>(base + header->symbol_offset);
+    const IRScope* scopes = reinterpret_cast<const IRScope*>(base + header->scope_offset);
+    const uint32_t* indices = reinterpret_cast<const uint32_t*>(base + header->index_offset);
+    const char* strings = base + header->string_offset;
+
+    // Types (two passes so forward references resolve)
+    std::vector<TypeInfo*> type_objs(header->type_count);
+    for (uint32_t i = 0; i < header->type_count; ++i) {
+        type_objs[i] = new TypeInfo((base_type)types[i].base, types[i].width);
+    }
+    for (uint32_t i = 0; i < header->type_count; ++i) {
+        const IRType& rec = types[i];
+        TypeInfo* type = type_objs[i];
+        if (rec.ptr_type != IR_NONE) type->ptr_type = type_objs[rec.ptr_type];
+        if (rec.return_type != IR_NONE) type->return_type = type_objs[rec.return_type];
+        for (uint32_t d = 0; d < rec.dim_count; ++d) type->dims.push_back((int)indices[rec.first_dim + d]);
+        for (uint32_t p = 0; p < rec.param_count; ++p) type->param_types.push_back(type_objs[indices[rec.first_param + p]]);
+    }
+
+    // Scopes and symbols
+    if (global_symbol_table) cleanup_translator();
+    std::vector<SymbolTable*> scope_objs(header->scope_count);
+    std::vector<Symbol*> symbol_objs(header->symbol_count);
+    for (uint32_t i = 0; i < header->scope_count; ++i) {
+        const IRScope& rec = scopes[i];
+        SymbolTable* parent = rec.parent != IR_NONE ? scope_objs[rec.parent] : nullptr;
+        scope_objs[i] = new SymbolTable(parent, rec.level, strings + rec.name);
+        if (parent) parent->child_scopes.push_back(scope_objs[i]);
+        for (uint32_t s = rec.first_symbol; s < rec.first_symbol + rec.symbol_count; ++s) {
+            const IRSymbol& sym_rec = symbols[s];
+            Symbol* sym = new Symbol(strings + sym_rec.name, sym_rec.type != IR_NONE ? type_objs[sym_rec.type] : nullptr,
+                                     sym_rec.size, sym_rec.offset);
+            sym->initial_value = strings + sym_rec.initial_value;
+            sym->is_temp = (sym_rec.flags & IR_SYM_TEMP) != 0;
+            symbol_objs[s] = sym;
+            scope_objs[i]->symbols[sym->name] = sym;
+        }
+    }
+    for (uint32_t s = 0; s < header->symbol_count; ++s) {
+        const IRSymbol& rec = symbols[s];
+        if (!symbol_objs[s]) continue;
+        if (rec.nested_table != IR_NONE) symbol_objs[s]->nested_table = scope_objs[rec.nested_table];
+        for (uint32_t p = 0; p < rec.param_count; ++p) symbol_objs[s]->parameters.push_back(symbol_objs[indices[rec.first_param + p]]);
+    }
+    global_symbol_table = header->scope_count ? scope_objs[0] : new SymbolTable(nullptr, 0);
+    current_symbol_table = global_symbol_table;
+
+    // Quads
+    quad_list.clear();
+    quad_list.reserve(header->quad_count);
+    for (uint32_t i = 0; i < header->quad_count; ++i) {
+        const IRQuad& rec = quads[i];
+        quad_list.emplace_back((op_code)rec.op, strings + rec.result, strings + rec.arg1, strings + rec.arg2,
+                               (operand_class)rec.type_class);
+    }
+    quad_base = header->first_quad_index;
+    next_quad_index = quad_base + header->quad_count;
+
+    // Keep new temporaries (created by later stages) from colliding with loaded ones
+    temp_counter = 0;
+    for (Symbol* sym : symbol_objs) {
+        if (sym && sym->is_temp && sym->name.size() > 1 && sym->name[0] == 't') {
+            temp_counter = std::max(temp_counter, atoi(sym->name.c_str() + 1) + 1);
+        }
+    }
+
+    munmap(mapping, file_size);
+    return true;
+}
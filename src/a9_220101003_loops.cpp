@@ -0,0 +1,213 @@
+#include "a9_220101003.h"
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
+// --- Loop idiom recognition (-O) ---
+// Replaces counted loops that fill or copy an array element by element,
+//     for (i = 0; i < N; i = i + 1) begin a[i] = v; end
+//     for (i = 0; i < N; i = i + 1) begin b[i] = a[i]; end
+// with one OP_BLOCK_FILL / OP_BLOCK_COPY over N elements followed by "i = N",
+// so a backend can run them as memset/memcpy or with word-wide stores. The
+// loop is matched on the CFG in the shape the FOR rule emits it:
+//     C: [t = N]  if i < t goto B     (or <=)
+//     G: goto E
+//     I: [t = 1]  t' = i + t; i = t'; goto C
+//     B: offset, value and store quads; goto I
+//     E: ...
+// i must start at 0 on entry (the quad before C stores 0 to it), N must be a
+// constant within the arrays' first dimension, and nothing else may jump into
+// the loop or use its temporaries.
+
+struct LoopIdiom {
+    int begin = 0;                     // First quad of the loop (C)
+    int end = 0;                       // One past its last quad (E)
+    Quad block_op{OP_BLOCK_FILL, ""};  // OP_BLOCK_FILL / OP_BLOCK_COPY replacing it
+    Quad final_value{OP_ASSIGN, ""};   // i = N
+    long long elements = 0;
+};
+
+// Constant held by an operand: a literal, or a temp defined by "t = <literal>" in defs
+static bool constant_operand(const std::string& operand, const std::unordered_map<std::string, std::string>& defs,
+                             std::string& value) {
+    if (is_constant_operand(operand)) { value = operand; return true; }
+    auto it = defs.find(operand);
+    if (it == defs.end()) return false;
+    value = it->second;
+    return true;
+}
+
+static bool integer_constant(const std::string& operand, const std::unordered_map<std::string, std::string>& defs,
+                             long long& value) {
+    std::string text;
+    if (!constant_operand(operand, defs, text) || text.find_first_of(".eE") != std::string::npos) return false;
+    value = atoll(text.c_str());
+    return true;
+}
+
+// Records "t = <literal>" quads of [begin, end) into defs; false if any other quad is found
+static bool only_constant_defs(int begin, int end, std::unordered_map<std::string, std::string>& defs) {
+    for (int i = begin; i < end; ++i) {
+        const Quad& quad = quad_list[i];
+        if (quad.op != OP_ASSIGN || !is_temp_name(quad.result) || !is_constant_operand(quad.arg1)) return false;
+        defs[quad.result] = quad.arg1;
+    }
+    return true;
+}
+
+static Symbol* array_symbol(const FunctionRange& fn, const std::string& name) {
+    Symbol* symbol = local_symbol(fn, name);
+    if (!symbol && global_symbol_table) symbol = global_symbol_table->lookup(name);
+    return symbol;
+}
+
+// Element class of a one-dimensional char/int/float array holding at least `elements` elements
+static operand_class array_class(const FunctionRange& fn, const std::string& name, long long elements) {
+    Symbol* symbol = array_symbol(fn, name);
+    if (!symbol || !symbol->type || symbol->type->base != TYPE_ARRAY || symbol->type->dims.size() != 1 ||
+        !symbol->type->ptr_type || symbol->type->dims[0] < elements) return CLASS_NONE;
+    operand_class element = class_of(symbol->type->ptr_type);
+    if (element != CLASS_I8 && element != CLASS_I32 && element != CLASS_F64) return CLASS_NONE;
+    if (symbol->type->ptr_type->width != class_size(element)) return CLASS_NONE;
+    return element;
+}
+
+static bool match_loop(const FunctionRange& fn, const FunctionCFG& cfg, int c, LoopIdiom& idiom) {
+    if (c < 1 || c + 3 >= (int)cfg.blocks.size()) return false;
+    const BasicBlock& cond = cfg.blocks[c];
+    const BasicBlock& exit_jump = cfg.blocks[c + 1];
+    const BasicBlock& incr = cfg.blocks[c + 2];
+    const BasicBlock& body = cfg.blocks[c + 3];
+
+    // C: [t = N] if i < t goto B
+    const Quad& test = quad_list[cond.end - 1];
+    if ((test.op != OP_IF_LT && test.op != OP_IF_LE) || test.type_class != CLASS_I32) return false;
+    if (test.result.empty() || std::stoi(test.result) - quad_base != body.begin) return false;
+    const std::string& counter = test.arg1;
+    Symbol* counter_sym = array_symbol(fn, counter);
+    if (is_temp_name(counter) || !counter_sym || !counter_sym->type || counter_sym->type->base != TYPE_INTEGER) return false;
+    std::unordered_map<std::string, std::string> defs;
+    long long bound = 0;
+    if (!only_constant_defs(cond.begin, cond.end - 1, defs) || !integer_constant(test.arg2, defs, bound)) return false;
+    long long elements = test.op == OP_IF_LT ? bound : bound + 1;
+    if (elements < 1) return false;
+
+    // G: goto E, with E right after the body
+    const Quad& leave = quad_list[exit_jump.begin];
+    if (exit_jump.end - exit_jump.begin != 1 || leave.op != OP_GOTO || leave.result.empty() ||
+        std::stoi(leave.result) - quad_base != body.end) return false;
+
+    // I: [t = 1] t' = i + t; i = t'; goto C
+    if (incr.end - incr.begin < 3) return false;
+    const Quad& add = quad_list[incr.end - 3];
+    const Quad& store = quad_list[incr.end - 2];
+    const Quad& back = quad_list[incr.end - 1];
+    long long step = 0;
+    if (!only_constant_defs(incr.begin, incr.end - 3, defs) || add.op != OP_PLUS || add.arg1 != counter ||
+        !integer_constant(add.arg2, defs, step) || step != 1 || !is_temp_name(add.result)) return false;
+    if (store.op != OP_ASSIGN || store.result != counter || store.arg1 != add.result) return false;
+    if (back.op != OP_GOTO || back.result.empty() || std::stoi(back.result) - quad_base != cond.begin) return false;
+
+    // B: constant temps, offsets i * size, loads and one store; goto I
+    const Quad& next = quad_list[body.end - 1];
+    if (next.op != OP_GOTO || next.result.empty() || std::stoi(next.result) - quad_base != incr.begin) return false;
+    std::unordered_map<std::string, long long> scaled;                        // t = i * size
+    std::unordered_map<std::string, std::pair<std::string, std::string>> loads; // t = a[offset]
+    const Quad* element_store = nullptr;
+    for (int i = body.begin; i < body.end - 1; ++i) {
+        const Quad& quad = quad_list[i];
+        long long size = 0;
+        if (element_store) return false; // The store must come last
+        if (quad.op == OP_ASSIGN && is_temp_name(quad.result) && is_constant_operand(quad.arg1)) defs[quad.result] = quad.arg1;
+        else if (quad.op == OP_MULT && is_temp_name(quad.result) && quad.arg1 == counter && integer_constant(quad.arg2, defs, size)) scaled[quad.result] = size;
+        else if (quad.op == OP_ARRAY_ACCESS && is_temp_name(quad.result)) loads[quad.result] = {quad.arg1, quad.arg2};
+        else if (quad.op == OP_ARRAY_ASSIGN) element_store = &quad;
+        else return false;
+    }
+    if (!element_store) return false;
+
+    // Offsets must index element i of the array
+    auto indexes_counter = [&](const std::string& offset, operand_class element) {
+        auto it = scaled.find(offset);
+        return (class_size(element) == 1 && offset == counter) || (it != scaled.end() && it->second == class_size(element));
+    };
+    const std::string& dst = element_store->result;
+    operand_class element = array_class(fn, dst, elements);
+    if (element == CLASS_NONE || element_store->type_class != element || !indexes_counter(element_store->arg1, element)) return false;
+
+    const std::string& value = element_store->arg2;
+    auto load = loads.find(value);
+    std::string fill;
+    if (load != loads.end()) {
+        const std::string& src = load->second.first;
+        if (array_class(fn, src, elements) != element || !indexes_counter(load->second.second, element)) return false;
+        idiom.block_op = Quad(OP_BLOCK_COPY, dst, src, std::to_string(elements * class_size(element)), element);
+    } else if (constant_operand(value, defs, fill) || (!is_temp_name(value) && value != counter && value != dst)) {
+        if (fill.empty()) fill = value; // Loop-invariant variable
+        idiom.block_op = Quad(OP_BLOCK_FILL, dst, fill, std::to_string(elements * class_size(element)), element);
+    } else {
+        return false;
+    }
+
+    // Entry only by falling into C with i = 0; the other blocks are reached only from within the loop
+    const BasicBlock& before = cfg.blocks[c - 1];
+    const Quad& init = quad_list[before.end - 1];
+    std::unordered_map<std::string, std::string> entry_defs;
+    for (int i = before.begin; i < before.end - 1; ++i) {
+        const Quad& quad = quad_list[i];
+        if (quad.op == OP_ASSIGN && is_temp_name(quad.result) && is_constant_operand(quad.arg1)) entry_defs[quad.result] = quad.arg1;
+    }
+    long long start = -1;
+    if (init.op != OP_ASSIGN || init.result != counter || !integer_constant(init.arg1, entry_defs, start) || start != 0) return false;
+    auto preds_are = [&](int b, std::vector<int> expected) {
+        std::vector<int> preds = cfg.blocks[b].preds;
+        std::sort(preds.begin(), preds.end());
+        std::sort(expected.begin(), expected.end());
+        return preds == expected;
+    };
+    if (!preds_are(c, {c - 1, c + 2}) || !preds_are(c + 1, {c}) || !preds_are(c + 2, {c + 3}) || !preds_are(c + 3, {c})) return false;
+
+    // Temporaries of the loop must be dead after it
+    std::unordered_set<std::string> loop_temps;
+    for (int i = cond.begin; i < body.end; ++i) {
+        if (is_temp_name(quad_list[i].result)) loop_temps.insert(quad_list[i].result);
+    }
+    for (int i = fn.begin + 1; i < fn.end; ++i) {
+        if (i == cond.begin) i = body.end;
+        if (i >= fn.end) break;
+        const Quad& quad = quad_list[i];
+        if (loop_temps.count(quad.arg1) || loop_temps.count(quad.arg2) || (loop_temps.count(quad.result) && !is_jump_op(quad.op))) return false;
+    }
+
+    idiom.begin = cond.begin;
+    idiom.end = body.end;
+    idiom.final_value = Quad(OP_ASSIGN, counter, std::to_string(elements), "", store.type_class);
+    idiom.elements = elements;
+    return true;
+}
+
+void recognise_loop_idioms() {
+    std::vector<bool> removed(quad_list.size(), false);
+    std::map<int, std::vector<Quad>> replacements;
+    for (const FunctionRange& fn : find_functions()) {
+        FunctionCFG cfg = build_cfg(fn);
+        for (int c = 1; c + 3 < (int)cfg.blocks.size(); ++c) {
+            LoopIdiom idiom;
+            if (!match_loop(fn, cfg, c, idiom)) continue;
+            for (int i = idiom.begin; i < idiom.end; ++i) removed[i] = true;
+            replacements[idiom.begin] = {idiom.block_op, idiom.final_value};
+
+            const Quad& op = idiom.block_op;
+            std::string range = "[0.." + std::to_string(idiom.elements - 1) + "]";
+            std::string what = op.op == OP_BLOCK_FILL ? "loop filling " + op.result + range + " with " + op.arg1
+                                                      : "loop copying " + op.arg1 + range + " to " + op.result;
+            opt_report("idiom", "'" + fn.name + "': " + what + " (" + std::to_string(idiom.end - idiom.begin) +
+                       " quads) -> " + op.toString());
+            c += 3; // Continue after the body
+        }
+    }
+    if (!replacements.empty()) rewrite_quads(removed, replacements, {});
+}
@@ -0,0 +1,476 @@
+#include "a9_220101003.h"
+#include <iostream>
+#include <fstream>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <cctype>
+
+// --- Optimizer (-O) ---
+// Passes run on the finished quad list after parsing. They edit quad_list
+// through rewrite_quads(), which keeps absolute jump targets valid, and
+// describe what they changed in the compile report (output/<input>.report).
+
+bool optimize_mode = false;
+static std::vector<std::string> report_lines;
+
+void opt_report(const std::string& pass, const std::string& message) {
+    report_lines.push_back("[" + pass + "] " + message);
+}
+
+bool is_jump_op(op_code op) {
+    return op == OP_GOTO || op == OP_IF_FALSE || op == OP_IF_TRUE || (op >= OP_IF_LT && op <= OP_IF_NE);
+}
+
+bool is_constant_operand(const std::string& s) {
+    if (s.empty()) return false;
+    char c = s[0];
+    if (c == '-' || c == '+' || c == '.') return s.size() > 1 && (isdigit((unsigned char)s[1]) || s[1] == '.');
+    return isdigit((unsigned char)c);
+}
+
+std::vector<FunctionRange> find_functions() {
+    std::vector<FunctionRange> functions;
+    for (size_t i = 0; i < quad_list.size(); ++i) {
+        if (quad_list[i].op == OP_FUNC_BEGIN) {
+            functions.push_back({quad_list[i].result, (int)i, (int)i});
+        } else if (quad_list[i].op == OP_FUNC_END && !functions.empty() && functions.back().name == quad_list[i].result) {
+            functions.back().end = (int)i;
+        }
+    }
+    return functions;
+}
+
+FunctionCFG build_cfg(const FunctionRange& fn) {
+    FunctionCFG cfg;
+    int first = fn.begin + 1;
+    int count = fn.end - first;
+    if (count <= 0) return cfg;
+
+    // Leaders: the first body quad, every jump target and every quad after a jump, return or tail call
+    std::vector<bool> leader(count, false);
+    leader[0] = true;
+    for (int i = first; i < fn.end; ++i) {
+        const Quad& quad = quad_list[i];
+        if (is_jump_op(quad.op) && !quad.result.empty()) {
+            int target = std::stoi(quad.result) - quad_base;
+            if (target >= first && target < fn.end) leader[target - first] = true;
+        }
+        bool ends_block = is_jump_op(quad.op) || quad.op == OP_RETURN || quad.op == OP_TAILCALL;
+        if (ends_block && i + 1 < fn.end) leader[i + 1 - first] = true;
+    }
+    cfg.block_at.assign(count, 0);
+    for (int i = 0; i < count; ++i) {
+        if (leader[i]) cfg.blocks.push_back(BasicBlock{first + i, first + i, {}, {}});
+        cfg.blocks.back().end = first + i + 1;
+        cfg.block_at[i] = (int)cfg.blocks.size() - 1;
+    }
+
+    for (size_t b = 0; b < cfg.blocks.size(); ++b) {
+        BasicBlock& block = cfg.blocks[b];
+        const Quad& last = quad_list[block.end - 1];
+        if (is_jump_op(last.op) && !last.result.empty()) {
+            int target = std::stoi(last.result) - quad_base;
+            if (target >= first && target < fn.end) block.succs.push_back(cfg.block_at[target - first]);
+        }
+        bool falls_through = last.op != OP_GOTO && last.op != OP_RETURN && last.op != OP_TAILCALL;
+        if (falls_through && block.end < fn.end && (block.succs.empty() || block.succs[0] != (int)b + 1)) {
+            block.succs.push_back((int)b + 1);
+        }
+        for (int succ : block.succs) cfg.blocks[succ].preds.push_back((int)b);
+    }
+    return cfg;
+}
+
+void rewrite_quads(const std::vector<bool>& removed,
+                   const std::map<int, std::vector<Quad>>& insert_before,
+                   const std::map<int, std::vector<Quad>>& insert_after) {
+    int count = (int)quad_list.size();
+    std::vector<Quad> rewritten;
+    rewritten.reserve(count);
+    std::vector<int> new_start(count + 1, 0); // Where control arriving at old quad i now lands
+
+    for (int i = 0; i < count; ++i) {
+        new_start[i] = (int)rewritten.size();
+        auto before = insert_before.find(i);
+        if (before != insert_before.end()) rewritten.insert(rewritten.end(), before->second.begin(), before->second.end());
+        if (!removed[i]) rewritten.push_back(quad_list[i]);
+        auto after = insert_after.find(i);
+        if (after != insert_after.end()) rewritten.insert(rewritten.end(), after->second.begin(), after->second.end());
+    }
+    new_start[count] = (int)rewritten.size();
+
+    for (Quad& quad : rewritten) {
+        if (!is_jump_op(quad.op) || quad.result.empty()) continue;
+        int target = std::stoi(quad.result) - quad_base;
+        if (target >= 0 && target <= count) quad.result = std::to_string(quad_base + new_start[target]);
+    }
+    quad_list.swap(rewritten);
+    next_quad_index = quad_base + (int)quad_list.size();
+}
+
+// Names that occur as operands, i.e. are read somewhere (jump targets excluded)
+static void count_uses(std::unordered_map<std::string, int>& uses) {
+    uses.clear();
+    for (const Quad& quad : quad_list) {
+        if (!quad.arg1.empty()) uses[quad.arg1]++;
+        if (!quad.arg2.empty()) uses[quad.arg2]++;
+        switch (quad.op) {
+            case OP_PARAM: case OP_RETURN: case OP_DEREF_ASSIGN: case OP_BLOCK_FILL: case OP_BLOCK_COPY:
+                if (!quad.result.empty()) uses[quad.result]++; // result is read, not written
+                break;
+            default: break;
+        }
+    }
+}
+
+// Temporaries are single-assignment and always defined before use on every path
+static std::unordered_set<std::string> user_names;
+
+static void collect_user_names(SymbolTable* table) {
+    for (const auto& [name, symbol] : table->symbols) {
+        if (symbol && !symbol->is_temp) user_names.insert(name);
+    }
+    for (SymbolTable* child : table->child_scopes) collect_user_names(child);
+}
+
+bool is_temp_name(const std::string& name) {
+    if (name.size() < 2 || name[0] != 't') return false;
+    for (size_t i = 1; i < name.size(); ++i) {
+        if (!isdigit((unsigned char)name[i])) return false;
+    }
+    return !user_names.count(name);
+}
+
+// Removes definitions of temporaries that are never read; returns how many
+static int remove_dead_temps() {
+    int total = 0;
+    std::unordered_map<std::string, int> uses;
+    for (;;) {
+        count_uses(uses);
+        std::vector<bool> removed(quad_list.size(), false);
+        int count = 0;
+        for (size_t i = 0; i < quad_list.size(); ++i) {
+            const Quad& quad = quad_list[i];
+            switch (quad.op) {
+                case OP_ASSIGN: case OP_PLUS: case OP_MINUS: case OP_MULT: case OP_UMINUS: case OP_UPLUS:
+                case OP_LT: case OP_GT: case OP_LE: case OP_GE: case OP_EQ: case OP_NE:
+                case OP_AND: case OP_OR: case OP_NOT: case OP_ADDR: case OP_INT2FLOAT: case OP_FLOAT2INT:
+                case OP_ARRAY_ACCESS: case OP_ASSIGN_DEREF:
+                    if (is_temp_name(quad.result) && !uses.count(quad.result)) { removed[i] = true; count++; }
+                    break;
+                default: break;
+            }
+        }
+        if (count == 0) return total;
+        rewrite_quads(removed, {}, {});
+        total += count;
+    }
+}
+
+// --- Interprocedural pass ---
+
+struct CallSite {
+    int call;                // Index of the OP_CALL quad
+    int caller;              // Index into the function list, -1 for top-level code
+    std::vector<int> params; // Indices of its OP_PARAM quads, in argument order
+};
+
+struct ProgramInfo {
+    std::vector<FunctionRange> functions;
+    std::map<std::string, int> function_index;
+    std::vector<CallSite> calls;
+    std::unordered_map<std::string, std::string> temp_constants; // Temp defined by "t = <constant>"
+};
+
+static void analyse_program(ProgramInfo& info) {
+    info = ProgramInfo();
+    info.functions = find_functions();
+    for (size_t f = 0; f < info.functions.size(); ++f) info.function_index[info.functions[f].name] = f;
+
+    int current = -1;
+    std::vector<int> pending_params;
+    for (size_t i = 0; i < quad_list.size(); ++i) {
+        const Quad& quad = quad_list[i];
+        if (quad.op == OP_FUNC_BEGIN) { current = info.function_index[quad.result]; pending_params.clear(); }
+        else if (quad.op == OP_FUNC_END) { current = -1; pending_params.clear(); }
+        else if (quad.op == OP_PARAM) pending_params.push_back(i);
+        else if (quad.op == OP_CALL) {
+            size_t n = quad.arg2.empty() ? 0 : std::stoul(quad.arg2);
+            CallSite site{(int)i, current, {}};
+            if (n <= pending_params.size()) {
+                site.params.assign(pending_params.end() - n, pending_params.end());
+                pending_params.resize(pending_params.size() - n);
+            }
+            info.calls.push_back(site);
+        } else if (quad.op == OP_ASSIGN && is_constant_operand(quad.arg1) && is_temp_name(quad.result)) {
+            info.temp_constants[quad.result] = quad.arg1;
+        }
+    }
+}
+
+// The constant an operand is known to hold, or "" if unknown
+static std::string constant_value(const ProgramInfo& info, const std::string& operand) {
+    if (is_constant_operand(operand)) return operand;
+    auto it = info.temp_constants.find(operand);
+    return it == info.temp_constants.end() ? "" : it->second;
+}
+
+// The function's own declaration of name (parameter or local in any block), if any
+Symbol* local_symbol(const FunctionRange& fn, const std::string& name) {
+    Symbol* func_sym = global_symbol_table ? global_symbol_table->lookup(fn.name) : nullptr;
+    if (func_sym) {
+        for (Symbol* param : func_sym->parameters) if (param && param->name == name) return param;
+    }
+    std::vector<SymbolTable*> stack;
+    if (SymbolTable* scope = find_function_scope(fn.name)) stack.push_back(scope);
+    while (!stack.empty()) {
+        SymbolTable* table = stack.back();
+        stack.pop_back();
+        auto it = table->symbols.find(name);
+        if (it != table->symbols.end() && it->second) return it->second;
+        stack.insert(stack.end(), table->child_scopes.begin(), table->child_scopes.end());
+    }
+    return nullptr;
+}
+
+// Quad operands are not scope-qualified, so a name the function declares that is also a
+// global may refer to either (a block can store to the global while a sibling block
+// shadows it); only names that cannot be the global are certainly local
+static Symbol* certainly_local(const FunctionRange& fn, const std::string& name) {
+    if (global_symbol_table && global_symbol_table->lookup(name)) return nullptr;
+    return local_symbol(fn, name);
+}
+
+// No calls, no loops and no stores outside its own frame: removing a call to it is unobservable
+static bool is_pure_terminating(const FunctionRange& fn) {
+    for (int i = fn.begin + 1; i < fn.end; ++i) {
+        const Quad& quad = quad_list[i];
+        switch (quad.op) {
+            case OP_CALL: case OP_PARAM: case OP_DEREF_ASSIGN:
+                return false;
+            case OP_ARRAY_ASSIGN: { // Only stores into the function's own arrays stay local
+                Symbol* target = certainly_local(fn, quad.result);
+                if (!target || !target->type || target->type->base != TYPE_ARRAY) return false;
+                break;
+            }
+            case OP_GOTO: case OP_IF_FALSE: case OP_IF_TRUE:
+            case OP_IF_LT: case OP_IF_GT: case OP_IF_LE: case OP_IF_GE: case OP_IF_EQ: case OP_IF_NE:
+                if (quad.result.empty() || std::stoi(quad.result) - quad_base <= i) return false; // Backward or unpatched jump
+                break;
+            case OP_RETURN:
+                break;
+            default: // Everything else writes its result
+                if (!is_temp_name(quad.result) && !certainly_local(fn, quad.result)) return false;
+                break;
+        }
+    }
+    return true;
+}
+
+// Calls whose arguments are the same constant at every call site become a local initialisation
+static int specialise_constant_arguments(ProgramInfo& info) {
+    std::vector<bool> removed(quad_list.size(), false);
+    std::map<int, std::vector<Quad>> entry_inits;
+    int specialised = 0;
+
+    for (const FunctionRange& fn : info.functions) {
+        if (fn.name == "main") continue;
+        Symbol* func_sym = global_symbol_table ? global_symbol_table->lookup(fn.name) : nullptr;
+        if (!func_sym || !func_sym->type || func_sym->parameters.empty()) continue;
+
+        std::vector<const CallSite*> sites;
+        bool usable = true;
+        for (const CallSite& site : info.calls) {
+            if (quad_list[site.call].arg1 != fn.name) continue;
+            if (site.params.size() != func_sym->parameters.size()) usable = false;
+            sites.push_back(&site);
+        }
+        if (sites.empty() || !usable) continue;
+
+        std::string bound; // "name = value" list for the report, in parameter order
+        for (int k = (int)func_sym->parameters.size() - 1; k >= 0; --k) {
+            std::string value = constant_value(info, quad_list[sites[0]->params[k]].result);
+            for (const CallSite* site : sites) {
+                if (value.empty() || constant_value(info, quad_list[site->params[k]].result) != value) { value.clear(); break; }
+            }
+            if (value.empty()) continue;
+
+            Symbol* param = func_sym->parameters[k];
+            for (const CallSite* site : sites) {
+                removed[site->params[k]] = true;
+                Quad& call = quad_list[site->call];
+                call.arg2 = std::to_string(std::stoi(call.arg2) - 1);
+            }
+            entry_inits[fn.begin].insert(entry_inits[fn.begin].begin(), Quad(OP_ASSIGN, param->name, value, "", class_of(param->type)));
+            func_sym->parameters.erase(func_sym->parameters.begin() + k);
+            if (k < (int)func_sym->type->param_types.size()) {
+                delete func_sym->type->param_types[k];
+                func_sym->type->param_types.erase(func_sym->type->param_types.begin() + k);
+            }
+            bound = param->name + " = " + value + (bound.empty() ? "" : ", " + bound);
+            specialised++;
+        }
+        if (!bound.empty()) {
+            opt_report("ipa", "specialised '" + fn.name + "' for " + bound + " (same constant at all " +
+                       std::to_string(sites.size()) + " call site(s))");
+        }
+    }
+    if (specialised) rewrite_quads(removed, {}, entry_inits); // Loops back to the entry skip the initialisation
+    return specialised;
+}
+
+// The constant every return of fn yields, or "" if it may vary
+static std::string constant_return(const ProgramInfo& info, const FunctionRange& fn) {
+    Symbol* func_sym = global_symbol_table ? global_symbol_table->lookup(fn.name) : nullptr;
+    if (!func_sym || !func_sym->type || !func_sym->type->return_type || func_sym->type->return_type->base == TYPE_VOID) return "";
+    if (fn.end - 1 <= fn.begin || quad_list[fn.end - 1].op != OP_RETURN) return ""; // May fall off the end
+    std::string value;
+    for (int i = fn.begin + 1; i < fn.end; ++i) {
+        const Quad& quad = quad_list[i];
+        if (is_jump_op(quad.op) && (quad.result.empty() || std::stoi(quad.result) - quad_base == fn.end)) return "";
+        if (quad.op != OP_RETURN) continue;
+        std::string v = constant_value(info, quad.result);
+        if (v.empty() || (!value.empty() && v != value)) return "";
+        value = v;
+    }
+    return value;
+}
+
+static int propagate_constant_returns(ProgramInfo& info) {
+    std::unordered_map<std::string, std::string> replacement; // Call result temp -> constant
+    std::vector<bool> removed(quad_list.size(), false);
+    int folded = 0;
+
+    for (const FunctionRange& fn : info.functions) {
+        std::string value = constant_return(info, fn);
+        if (value.empty()) continue;
+        bool pure = is_pure_terminating(fn);
+        int sites = 0;
+        for (const CallSite& site : info.calls) {
+            Quad& call = quad_list[site.call];
+            if (call.arg1 != fn.name || call.result.empty() || !is_temp_name(call.result)) continue;
+            replacement[call.result] = value;
+            call.result.clear();
+            if (pure) {
+                removed[site.call] = true;
+                for (int p : site.params) removed[p] = true;
+            }
+            sites++;
+        }
+        if (sites == 0) continue;
+        opt_report("ipa", "'" + fn.name + "' always returns " + value + ": folded into " + std::to_string(sites) +
+                   " call site(s)" + (pure ? ", calls removed" : ", calls kept for their side effects"));
+        folded += sites;
+    }
+    if (!folded) return 0;
+
+    for (Quad& quad : quad_list) {
+        auto substitute = [&](std::string& operand) {
+            auto it = replacement.find(operand);
+            if (it != replacement.end()) operand = it->second;
+        };
+        substitute(quad.arg1);
+        substitute(quad.arg2);
+        if (quad.op == OP_PARAM || quad.op == OP_RETURN || quad.op == OP_DEREF_ASSIGN) substitute(quad.result);
+    }
+    rewrite_quads(removed, {}, {});
+    return folded;
+}
+
+// Calls to functions without observable effects whose result is not used
+static int remove_pure_calls(ProgramInfo& info) {
+    std::vector<bool> removed(quad_list.size(), false);
+    int count = 0;
+    for (const FunctionRange& fn : info.functions) {
+        if (!is_pure_terminating(fn)) continue;
+        int sites = 0;
+        for (const CallSite& site : info.calls) {
+            const Quad& call = quad_list[site.call];
+            if (call.arg1 != fn.name || !call.result.empty()) continue;
+            removed[site.call] = true;
+            for (int p : site.params) removed[p] = true;
+            sites++;
+        }
+        if (sites) opt_report("ipa", "removed " + std::to_string(sites) + " call(s) to '" + fn.name + "': no effects and result unused");
+        count += sites;
+    }
+    if (count) rewrite_quads(removed, {}, {});
+    return count;
+}
+
+static int remove_unreachable_functions(ProgramInfo& info) {
+    std::set<std::string> reachable;
+    std::vector<std::string> worklist;
+    auto mark = [&](const std::string& name) {
+        if (info.function_index.count(name) && reachable.insert(name).second) worklist.push_back(name);
+    };
+    mark("main");
+    for (const CallSite& site : info.calls) {
+        if (site.caller < 0) mark(quad_list[site.call].arg1); // Called by a global initialiser
+    }
+    for (const Quad& quad : quad_list) { // Function names used as values
+        if (quad.op == OP_CALL || quad.op == OP_FUNC_BEGIN || quad.op == OP_FUNC_END) continue;
+        mark(quad.arg1);
+        mark(quad.arg2);
+        if (quad.op == OP_PARAM || quad.op == OP_RETURN) mark(quad.result);
+    }
+    while (!worklist.empty()) {
+        int f = info.function_index[worklist.back()];
+        worklist.pop_back();
+        for (const CallSite& site : info.calls) {
+            if (site.caller == f) mark(quad_list[site.call].arg1);
+        }
+    }
+
+    std::vector<bool> removed(quad_list.size(), false);
+    int count = 0;
+    for (const FunctionRange& fn : info.functions) {
+        if (reachable.count(fn.name)) continue;
+        for (int i = fn.begin; i <= fn.end; ++i) removed[i] = true;
+        opt_report("ipa", "removed '" + fn.name + "': unreachable from main (" + std::to_string(fn.end - fn.begin + 1) + " quads)");
+        count++;
+    }
+    if (count) rewrite_quads(removed, {}, {});
+    return count;
+}
+
+void optimize_program() {
+    if (quad_base != 0) return; // Whole-program passes need every quad in memory
+    PhaseTimer timer(PHASE_OPTIMIZE);
+    size_t quads_before = quad_list.size();
+    user_names.clear();
+    if (global_symbol_table) collect_user_names(global_symbol_table);
+
+    ProgramInfo info;
+    analyse_program(info);
+    specialise_constant_arguments(info);
+    analyse_program(info);
+    propagate_constant_returns(info);
+    analyse_program(info);
+    remove_pure_calls(info);
+    analyse_program(info);
+    remove_unreachable_functions(info);
+
+    int dead = remove_dead_temps();
+    if (dead) opt_report("dce", "removed " + std::to_string(dead) + " dead temporary definition(s)");
+    recognise_loop_idioms();
+    eliminate_tail_calls();
+    narrow_integer_widths();
+
+    opt_report("summary", std::to_string(quads_before) + " quads before, " + std::to_string(quad_list.size()) + " after");
+    if (stats_enabled) stats_record_optimized((long)quad_list.size());
+    std::cout << "Optimizer: " << quads_before << " -> " << quad_list.size() << " quads" << std::endl;
+}
+
+bool write_opt_report(const std::string& filename) {
+    std::ofstream out(filename);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not open report output file: " << filename << std::endl;
+        return false;
+    }
+    out << "--- Optimization Report ---\n";
+    for (const std::string& line : report_lines) out << line << "\n";
+    std::cout << "Optimization report written to " << filename << std::endl;
+    return true;
+}
@@ -0,0 +1,514 @@
+#include "a9_220101003.h"
+#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
+// --- Value-range analysis and integer narrowing (-O) ---
+// Computes an interval for every integer temporary and scalar local of each
+// function by abstract interpretation over its CFG. Facts come from literals,
+// the bounds tested by conditional jumps (for-loop conditions in particular),
+// array dimensions (an element access implies an in-bounds index) and
+// char-typed loads. Arithmetic, comparisons and moves whose values provably fit
+// in 8 or 16 bits get the class .i8/.i16, and every function with narrowed
+// quads gets a line in the compile report. Temporaries and scalar locals that
+// only ever hold such values have their size annotated with the narrower
+// width; frames are not laid out here (offsets stay 0), so this records what a
+// backend may allocate rather than memory already saved.
+//
+// Values follow the interpreter: .i32 arithmetic wraps at 32 bits, stores of
+// a narrower class truncate, and locals read as 0 before their first store.
+// Globals, parameters, arrays and locals whose address is taken are not
+// tracked and keep their declared range.
+
+struct Interval {
+    long long lo;
+    long long hi;
+    bool operator==(const Interval& other) const { return lo == other.lo && hi == other.hi; }
+    bool operator!=(const Interval& other) const { return !(*this == other); }
+};
+
+static const Interval FULL_RANGE = {INT32_MIN, INT32_MAX};
+static const Interval I8_RANGE = {-128, 127};
+static const Interval I16_RANGE = {-32768, 32767};
+static const int WIDEN_AFTER_VISITS = 3; // Loop heads give up on growing bounds after this
+static const int NARROWING_ROUNDS = 2;   // Descending passes that recover bounds lost to widening
+
+static Interval join(const Interval& a, const Interval& b) {
+    return {std::min(a.lo, b.lo), std::max(a.hi, b.hi)};
+}
+
+static bool within(const Interval& a, const Interval& b) {
+    return a.lo >= b.lo && a.hi <= b.hi;
+}
+
+// Anything outside int32 wraps, after which nothing is known about the value
+static Interval wrap32(long long lo, long long hi) {
+    if (lo < INT32_MIN || hi > INT32_MAX) return FULL_RANGE;
+    return {lo, hi};
+}
+
+// A store of class .i8/.i16 truncates values that do not fit
+static Interval stored_as(const Interval& value, operand_class type_class) {
+    if (type_class == CLASS_I8 && !within(value, I8_RANGE)) return I8_RANGE;
+    if (type_class == CLASS_I16 && !within(value, I16_RANGE)) return I16_RANGE;
+    return value;
+}
+
+static int width_of(const Interval& value) {
+    if (within(value, I8_RANGE)) return 8;
+    if (within(value, I16_RANGE)) return 16;
+    return 32;
+}
+
+static operand_class class_of_width(int width) {
+    return width == 8 ? CLASS_I8 : (width == 16 ? CLASS_I16 : CLASS_I32);
+}
+
+static bool is_integer_class(operand_class type_class) {
+    return type_class == CLASS_I8 || type_class == CLASS_I16 || type_class == CLASS_I32;
+}
+
+static Interval arithmetic(op_code op, const Interval& a, const Interval& b) {
+    switch (op) {
+        case OP_PLUS: return wrap32(a.lo + b.lo, a.hi + b.hi);
+        case OP_MINUS: return wrap32(a.lo - b.hi, a.hi - b.lo);
+        case OP_MULT: {
+            long long p[4] = {a.lo * b.lo, a.lo * b.hi, a.hi * b.lo, a.hi * b.hi};
+            return wrap32(*std::min_element(p, p + 4), *std::max_element(p, p + 4));
+        }
+        case OP_DIV: { // |a / b| <= |a|
+            long long m = std::max(llabs(a.lo), llabs(a.hi));
+            return wrap32(-m, m);
+        }
+        case OP_MOD: { // |a % b| < |b| and <= |a|, with the sign of a
+            long long m = std::max(llabs(b.lo), llabs(b.hi));
+            long long r = std::min(m > 0 ? m - 1 : 0, std::max(llabs(a.lo), llabs(a.hi)));
+            return {a.lo >= 0 ? 0 : -r, a.hi <= 0 ? 0 : r};
+        }
+        default: return FULL_RANGE;
+    }
+}
+
+// Integer value produced into quad.result, if the quad defines one
+static bool defines_integer(const Quad& quad) {
+    switch (quad.op) {
+        case OP_ASSIGN: case OP_PLUS: case OP_MINUS: case OP_MULT: case OP_DIV: case OP_MOD:
+        case OP_UMINUS: case OP_UPLUS: case OP_ARRAY_ACCESS: case OP_ASSIGN_DEREF:
+            return is_integer_class(quad.type_class);
+        case OP_CALL:
+            return !quad.result.empty() && is_integer_class(quad.type_class);
+        case OP_FLOAT2INT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+struct RangeState {
+    bool reachable = false;
+    std::vector<Interval> locals;
+};
+
+struct RangeAnalysis {
+    const FunctionRange& fn;
+    FunctionCFG cfg;
+    bool has_scope = false;
+    std::unordered_map<std::string, Symbol*> declared; // Function's own declarations (temps included)
+    std::unordered_set<std::string> params;
+    const std::unordered_set<std::string>& converted; // FLOAT2INT results anywhere in the program
+
+    std::unordered_map<std::string, int> local_ids;
+    std::vector<std::string> local_names;
+    std::unordered_map<std::string, int> temp_ids;
+    std::vector<Interval> temp_range;
+    std::vector<bool> temp_known;
+    // Offset temp of "t = i * size" -> (local i, element size), to bound i by the array's dims
+    std::unordered_map<std::string, std::pair<int, long long>> scaled_index;
+
+    std::vector<RangeState> in;
+    std::vector<RangeState> out;
+
+    // Recorded by the final pass
+    bool recording = false;
+    std::vector<Interval> slot_range;            // Join of every value stored to each local
+    std::unordered_map<int, int> quad_width;     // Quad index -> width its operands and result need
+
+    RangeAnalysis(const FunctionRange& f, const std::unordered_set<std::string>& float_converted)
+        : fn(f), converted(float_converted) {}
+
+    void collect_declarations(SymbolTable* table, std::unordered_map<std::string, bool>& scalar) {
+        for (const auto& [name, symbol] : table->symbols) {
+            if (!symbol) continue;
+            declared.emplace(name, symbol);
+            bool is_scalar = symbol->type && (symbol->type->base == TYPE_INTEGER || symbol->type->base == TYPE_CHAR);
+            auto it = scalar.find(name);
+            scalar[name] = (it == scalar.end() ? true : it->second) && is_scalar;
+        }
+        for (SymbolTable* child : table->child_scopes) collect_declarations(child, scalar);
+    }
+
+    void identify_variables() {
+        Symbol* func_sym = global_symbol_table ? global_symbol_table->lookup(fn.name) : nullptr;
+        if (func_sym) {
+            for (Symbol* param : func_sym->parameters) if (param) params.insert(param->name);
+        }
+        std::unordered_map<std::string, bool> scalar;
+        if (SymbolTable* scope = find_function_scope(fn.name)) {
+            has_scope = true;
+            collect_declarations(scope, scalar);
+        }
+
+        std::unordered_set<std::string> address_taken;
+        std::unordered_map<std::string, int> temp_defs;
+        for (int i = fn.begin + 1; i < fn.end; ++i) {
+            const Quad& quad = quad_list[i];
+            if (quad.op == OP_ADDR) address_taken.insert(quad.arg1);
+            if (defines_integer(quad) && is_temp_name(quad.result)) temp_defs[quad.result]++;
+            else if (!quad.result.empty() && is_temp_name(quad.result) && !is_jump_op(quad.op)) temp_defs[quad.result] += 2; // Non-integer
+        }
+        for (const auto& [name, is_scalar] : scalar) {
+            Symbol* symbol = declared[name];
+            if (!is_scalar || symbol->is_temp || params.count(name) || address_taken.count(name)) continue;
+            local_ids[name] = (int)local_names.size();
+            local_names.push_back(name);
+        }
+        for (const auto& [name, defs] : temp_defs) {
+            if (defs != 1 || local_ids.count(name)) continue; // Single integer definition only
+            temp_ids[name] = (int)temp_range.size();
+            temp_range.push_back(FULL_RANGE);
+        }
+        temp_known.assign(temp_range.size(), false);
+    }
+
+    // Range of a name that is not tracked: from its declaration
+    Interval declared_range(const std::string& name) const {
+        if (params.count(name) || converted.count(name)) return FULL_RANGE;
+        Symbol* symbol = nullptr;
+        auto it = declared.find(name);
+        if (it != declared.end()) symbol = it->second;
+        else if (has_scope && global_symbol_table) symbol = global_symbol_table->lookup(name);
+        if (symbol && symbol->type && symbol->type->base == TYPE_CHAR) return I8_RANGE; // Char stores truncate
+        return FULL_RANGE;
+    }
+
+    Interval value(const std::string& name, const RangeState& state) const {
+        if (is_constant_operand(name)) {
+            if (name.find_first_of(".eE") != std::string::npos) return FULL_RANGE;
+            long long v = atoll(name.c_str());
+            return wrap32(v, v);
+        }
+        auto local = local_ids.find(name);
+        if (local != local_ids.end()) return state.locals[local->second];
+        auto temp = temp_ids.find(name);
+        if (temp != temp_ids.end()) return temp_known[temp->second] ? temp_range[temp->second] : FULL_RANGE;
+        return declared_range(name);
+    }
+
+    // Element accesses are assumed in bounds, so the index of a[i] lies in [0, dims[0] - 1]
+    void bound_index(const std::string& array, const std::string& offset, RangeState& state) {
+        Symbol* symbol = nullptr;
+        auto it = declared.find(array);
+        if (it != declared.end()) symbol = it->second;
+        else if (has_scope && global_symbol_table) symbol = global_symbol_table->lookup(array);
+        if (!symbol || !symbol->type || symbol->type->base != TYPE_ARRAY || symbol->type->dims.empty() ||
+            !symbol->type->ptr_type) return;
+        long long elements = symbol->type->dims[0];
+        long long element_size = symbol->type->ptr_type->width;
+        if (elements <= 0) return;
+
+        int id = -1;
+        auto local = local_ids.find(offset);
+        auto scaled = scaled_index.find(offset);
+        if (local != local_ids.end() && element_size == 1) id = local->second;
+        else if (scaled != scaled_index.end() && scaled->second.second == element_size) id = scaled->second.first;
+        if (id < 0) return;
+        Interval& v = state.locals[id];
+        v = {std::max(v.lo, 0LL), std::min(v.hi, elements - 1)};
+        if (v.lo > v.hi) v = {0, elements - 1}; // Only an out-of-bounds access gets here
+    }
+
+    void define(const std::string& name, const Interval& v, RangeState& state, bool join_temps) {
+        auto local = local_ids.find(name);
+        if (local != local_ids.end()) {
+            state.locals[local->second] = v;
+            if (recording) slot_range[local->second] = join(slot_range[local->second], v);
+            return;
+        }
+        auto temp = temp_ids.find(name);
+        if (temp == temp_ids.end()) return;
+        int id = temp->second;
+        temp_range[id] = (join_temps && temp_known[id]) ? join(temp_range[id], v) : v;
+        temp_known[id] = true;
+    }
+
+    void transfer_quad(int index, RangeState& state, bool join_temps) {
+        const Quad& quad = quad_list[index];
+        switch (quad.op) {
+            case OP_ASSIGN:
+                if (is_integer_class(quad.type_class)) {
+                    Interval v = stored_as(value(quad.arg1, state), quad.type_class);
+                    if (recording) quad_width[index] = width_of(v);
+                    define(quad.result, v, state, join_temps);
+                }
+                break;
+            case OP_PLUS: case OP_MINUS: case OP_MULT: case OP_DIV: case OP_MOD:
+                if (is_integer_class(quad.type_class)) {
+                    Interval a = value(quad.arg1, state), b = value(quad.arg2, state);
+                    Interval r = arithmetic(quad.op, a, b);
+                    if (recording) quad_width[index] = std::max({width_of(a), width_of(b), width_of(r)});
+                    if (quad.op == OP_MULT && local_ids.count(quad.arg1) && b.lo == b.hi && temp_ids.count(quad.result)) {
+                        scaled_index[quad.result] = {local_ids[quad.arg1], b.lo}; // Offset of an element access
+                    }
+                    define(quad.result, r, state, join_temps);
+                }
+                break;
+            case OP_UMINUS: case OP_UPLUS:
+                if (is_integer_class(quad.type_class)) {
+                    Interval a = value(quad.arg1, state);
+                    Interval r = quad.op == OP_UMINUS ? wrap32(-a.hi, -a.lo) : a;
+                    if (recording) quad_width[index] = std::max(width_of(a), width_of(r));
+                    define(quad.result, r, state, join_temps);
+                }
+                break;
+            case OP_IF_LT: case OP_IF_GT: case OP_IF_LE: case OP_IF_GE: case OP_IF_EQ: case OP_IF_NE:
+                if (recording && is_integer_class(quad.type_class)) {
+                    quad_width[index] = std::max(width_of(value(quad.arg1, state)), width_of(value(quad.arg2, state)));
+                }
+                break;
+            case OP_ARRAY_ACCESS:
+                if (defines_integer(quad)) define(quad.result, quad.type_class == CLASS_I8 ? I8_RANGE : FULL_RANGE, state, join_temps);
+                bound_index(quad.arg1, quad.arg2, state);
+                break;
+            case OP_ARRAY_ASSIGN:
+                bound_index(quad.result, quad.arg1, state);
+                break;
+            case OP_ASSIGN_DEREF: case OP_CALL:
+                if (defines_integer(quad)) define(quad.result, quad.type_class == CLASS_I8 ? I8_RANGE : FULL_RANGE, state, join_temps);
+                break;
+            case OP_FLOAT2INT:
+                define(quad.result, FULL_RANGE, state, join_temps);
+                break;
+            default:
+                break;
+        }
+    }
+
+    RangeState transfer(int b, RangeState state, bool join_temps) {
+        for (int i = cfg.blocks[b].begin; i < cfg.blocks[b].end; ++i) transfer_quad(i, state, join_temps);
+        return state;
+    }
+
+    // State along the edge from block b to succ, refined by b's conditional jump
+    RangeState edge_state(int b, int succ, const RangeState& state) const {
+        RangeState edge = state;
+        const Quad& last = quad_list[cfg.blocks[b].end - 1];
+        if (last.op < OP_IF_LT || last.op > OP_IF_NE || !is_integer_class(last.type_class) || last.result.empty()) return edge;
+        int target = std::stoi(last.result) - quad_base;
+        bool taken = target >= fn.begin + 1 && target < fn.end && cfg.block_at[target - (fn.begin + 1)] == succ;
+        bool falls = succ == b + 1;
+        if (taken == falls) return edge; // Both edges lead here (or neither): nothing to learn
+
+        op_code op = last.op;
+        if (!taken) { // Negate the condition on the fall-through edge
+            switch (op) {
+                case OP_IF_LT: op = OP_IF_GE; break; case OP_IF_GE: op = OP_IF_LT; break;
+                case OP_IF_GT: op = OP_IF_LE; break; case OP_IF_LE: op = OP_IF_GT; break;
+                case OP_IF_EQ: op = OP_IF_NE; break; default: op = OP_IF_EQ; break;
+            }
+        }
+        Interval a = value(last.arg1, state), b_range = value(last.arg2, state);
+        Interval na = a, nb = b_range;
+        switch (op) {
+            case OP_IF_LT: na.hi = std::min(a.hi, b_range.hi - 1); nb.lo = std::max(b_range.lo, a.lo + 1); break;
+            case OP_IF_LE: na.hi = std::min(a.hi, b_range.hi); nb.lo = std::max(b_range.lo, a.lo); break;
+            case OP_IF_GT: na.lo = std::max(a.lo, b_range.lo + 1); nb.hi = std::min(b_range.hi, a.hi - 1); break;
+            case OP_IF_GE: na.lo = std::max(a.lo, b_range.lo); nb.hi = std::min(b_range.hi, a.hi); break;
+            case OP_IF_EQ: na = nb = {std::max(a.lo, b_range.lo), std::min(a.hi, b_range.hi)}; break;
+            default: return edge; // != only excludes a point
+        }
+        if (na.lo > na.hi || nb.lo > nb.hi) { edge.reachable = false; return edge; }
+        auto refine = [&](const std::string& name, const Interval& v) {
+            auto local = local_ids.find(name);
+            if (local != local_ids.end()) edge.locals[local->second] = v;
+        };
+        refine(last.arg1, na);
+        refine(last.arg2, nb);
+        return edge;
+    }
+
+    RangeState entry_state() const {
+        RangeState state;
+        state.reachable = true;
+        state.locals.assign(local_names.size(), Interval{0, 0}); // Locals read as 0 before their first store
+        return state;
+    }
+
+    RangeState join_predecessors(int b) const {
+        RangeState joined = b == 0 ? entry_state() : RangeState(); // The entry may also be a loop head
+        for (int pred : cfg.blocks[b].preds) {
+            if (!out[pred].reachable) continue;
+            RangeState edge = edge_state(pred, b, out[pred]);
+            if (!edge.reachable) continue;
+            if (!joined.reachable) { joined = edge; continue; }
+            for (size_t v = 0; v < joined.locals.size(); ++v) joined.locals[v] = join(joined.locals[v], edge.locals[v]);
+        }
+        return joined;
+    }
+
+    void solve() {
+        int count = (int)cfg.blocks.size();
+        in.assign(count, RangeState());
+        out.assign(count, RangeState());
+        std::vector<int> visits(count, 0);
+        std::vector<bool> loop_head(count, false); // Target of a backward edge; widening happens only here
+        for (int b = 0; b < count; ++b) {
+            for (int pred : cfg.blocks[b].preds) if (pred >= b) loop_head[b] = true;
+        }
+        // Widening jumps to the next constant the function uses (a loop bound, most likely) or to a type limit
+        std::set<long long> thresholds = {INT32_MIN, I16_RANGE.lo, I8_RANGE.lo, 0, I8_RANGE.hi, I16_RANGE.hi, INT32_MAX};
+        for (int i = fn.begin + 1; i < fn.end; ++i) {
+            for (const std::string* operand : {&quad_list[i].arg1, &quad_list[i].arg2}) {
+                if (!is_constant_operand(*operand) || operand->find_first_of(".eE") != std::string::npos) continue;
+                long long c = atoll(operand->c_str());
+                for (long long t : {c - 1, c, c + 1}) if (t >= INT32_MIN && t <= INT32_MAX) thresholds.insert(t);
+            }
+        }
+        std::set<int> worklist; // Lowest block first keeps loops together
+        in[0] = entry_state();
+        worklist.insert(0);
+
+        // Ascending phase: joins, with widening at loop heads that keep changing
+        while (!worklist.empty()) {
+            int b = *worklist.begin();
+            worklist.erase(worklist.begin());
+            visits[b]++;
+            out[b] = transfer(b, in[b], true);
+            for (int succ : cfg.blocks[b].succs) {
+                RangeState edge = edge_state(b, succ, out[b]);
+                if (!edge.reachable) continue;
+                RangeState next = edge;
+                if (in[succ].reachable) {
+                    for (size_t v = 0; v < next.locals.size(); ++v) {
+                        Interval old = in[succ].locals[v];
+                        Interval joined = join(old, edge.locals[v]);
+                        if (loop_head[succ] && visits[succ] >= WIDEN_AFTER_VISITS) {
+                            if (joined.lo < old.lo) joined.lo = *std::prev(thresholds.upper_bound(joined.lo));
+                            if (joined.hi > old.hi) joined.hi = *thresholds.lower_bound(joined.hi);
+                        }
+                        next.locals[v] = joined;
+                    }
+                    if (next.locals == in[succ].locals) continue;
+                }
+                in[succ] = next;
+                worklist.insert(succ);
+            }
+        }
+
+        // Descending phase: recompute from the (sound) post-fixpoint without widening
+        for (int round = 0; round < NARROWING_ROUNDS; ++round) {
+            for (int b = 0; b < count; ++b) {
+                if (!in[b].reachable) continue;
+                in[b] = join_predecessors(b);
+                if (in[b].reachable) out[b] = transfer(b, in[b], false);
+            }
+        }
+
+        // Final pass: record the width every quad needs
+        recording = true;
+        slot_range.assign(local_names.size(), Interval{0, 0});
+        for (int b = 0; b < count; ++b) {
+            if (!in[b].reachable) continue;
+            in[b] = join_predecessors(b);
+            if (in[b].reachable) out[b] = transfer(b, in[b], false);
+        }
+    }
+};
+
+struct NarrowingTotals {
+    int quads = 0;
+    int temps = 0;
+    int locals = 0;
+};
+
+static void narrow_function(const FunctionRange& fn, const std::unordered_set<std::string>& converted, NarrowingTotals& totals) {
+    RangeAnalysis analysis(fn, converted);
+    analysis.cfg = build_cfg(fn);
+    if (analysis.cfg.blocks.empty()) return;
+    analysis.identify_variables();
+    analysis.solve();
+
+    std::vector<int> slot_width(analysis.local_names.size());
+    for (size_t v = 0; v < slot_width.size(); ++v) slot_width[v] = width_of(analysis.slot_range[v]);
+
+    int arithmetic_count = 0, compare_count = 0, move_count = 0, to_i8 = 0, to_i16 = 0;
+    for (const auto& [index, needed] : analysis.quad_width) {
+        Quad& quad = quad_list[index];
+        if (quad.type_class != CLASS_I32) continue; // Char quads are already 8 bits
+        int width = needed;
+        if (quad.op == OP_ASSIGN) {
+            auto local = analysis.local_ids.find(quad.result);
+            if (local != analysis.local_ids.end()) width = slot_width[local->second];
+            else if (!analysis.temp_ids.count(quad.result)) continue; // Globals and parameters keep their layout
+        } else if (quad.op != OP_IF_LT && quad.op != OP_IF_GT && quad.op != OP_IF_LE && quad.op != OP_IF_GE &&
+                   quad.op != OP_IF_EQ && quad.op != OP_IF_NE && !analysis.temp_ids.count(quad.result)) {
+            continue;
+        }
+        if (width >= 32) continue;
+        quad.type_class = class_of_width(width);
+        (width == 8 ? to_i8 : to_i16)++;
+        if (quad.op == OP_ASSIGN) move_count++;
+        else if (quad.op >= OP_IF_LT && quad.op <= OP_IF_NE) compare_count++;
+        else arithmetic_count++;
+    }
+    int narrowed = arithmetic_count + compare_count + move_count;
+
+    // Temporaries and locals are annotated with the width of everything stored in them
+    int temps = 0;
+    for (const auto& [name, id] : analysis.temp_ids) {
+        auto it = analysis.declared.find(name);
+        if (it == analysis.declared.end() || !analysis.temp_known[id] || it->second->size != 4) continue;
+        int size = width_of(analysis.temp_range[id]) / 8;
+        if (size >= 4) continue;
+        it->second->size = size;
+        temps++;
+    }
+    std::string slots;
+    int slot_count = 0; // Scalar locals
+    for (size_t v = 0; v < analysis.local_names.size(); ++v) {
+        Symbol* symbol = analysis.declared[analysis.local_names[v]];
+        int size = slot_width[v] / 8;
+        if (!symbol || symbol->size != 4 || size >= 4) continue;
+        slots += (slots.empty() ? "" : ", ") + analysis.local_names[v] + ": 4 -> " + std::to_string(size);
+        symbol->size = size;
+        slot_count++;
+    }
+
+    if (narrowed == 0 && temps == 0 && slot_count == 0) return;
+    std::string message = "'" + fn.name + "': " + std::to_string(narrowed) + " quad(s) narrowed (" +
+                          std::to_string(arithmetic_count) + " arithmetic, " + std::to_string(compare_count) + " compare, " +
+                          std::to_string(move_count) + " move; " + std::to_string(to_i8) + " to .i8, " +
+                          std::to_string(to_i16) + " to .i16), " + std::to_string(temps) + " temp(s) and " +
+                          std::to_string(slot_count) + " local(s) annotated narrower";
+    if (slot_count) message += " (" + slots + " bytes)";
+    opt_report("range", message);
+    totals.quads += narrowed;
+    totals.temps += temps;
+    totals.locals += slot_count;
+}
+
+void narrow_integer_widths() {
+    std::unordered_set<std::string> converted; // May hold out-of-range values whatever their declared type
+    for (const Quad& quad : quad_list) {
+        if (quad.op == OP_FLOAT2INT) converted.insert(quad.result);
+    }
+    NarrowingTotals totals;
+    for (const FunctionRange& fn : find_functions()) narrow_function(fn, converted, totals);
+    if (totals.quads || totals.temps || totals.locals) {
+        opt_report("range", "total: " + std::to_string(totals.quads) + " quad(s) narrowed, " + std::to_string(totals.temps) +
+                   " temp(s) and " + std::to_string(totals.locals) + " local(s) annotated narrower (widths only; no frame is re-laid out)");
+    }
+}
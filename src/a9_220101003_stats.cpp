@@ -0,0 +1,177 @@
+#include "a9_220101003.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <sys/resource.h> // getrusage()
+
+// --- Translation Statistics (--stats) ---
+// Wall time is charged to exactly one phase at a time. Entering a phase
+// pauses the enclosing one, so nested phases (the lexer running inside the
+// parser, typecheck inside a semantic action) are reported exclusively and
+// the phases add up to the total.
+
+typedef std::chrono::steady_clock stats_clock;
+
+struct ScopeStats {
+    std::string path;
+    int level;
+    int symbols;
+    int temps;
+};
+
+bool stats_enabled = false;
+
+static const char* PHASE_NAMES[PHASE_COUNT] = {
+    "driver", "lex", "parse", "backpatch", "typecheck", "symbol_table", "output", "cache", "optimize"
+};
+
+static stats_clock::time_point start_time;
+static stats_clock::time_point last_switch;
+static double phase_seconds[PHASE_COUNT] = {};
+static stats_phase current_phase = PHASE_DRIVER;
+static std::vector<stats_phase> phase_stack;
+
+static long token_count = 0;
+static long temp_count = 0;
+static std::vector<long> opcode_counts;
+static long optimized_quads = -1; // -1 unless -O ran
+static std::vector<ScopeStats> scope_stats;
+static std::vector<std::pair<std::string, long>> stage_peaks; // (stage, ru_maxrss in KB when it ended)
+
+static void switch_phase(stats_phase next) {
+    stats_clock::time_point now = stats_clock::now();
+    phase_seconds[current_phase] += std::chrono::duration<double>(now - last_switch).count();
+    last_switch = now;
+    current_phase = next;
+}
+
+PhaseTimer::PhaseTimer(stats_phase phase) : active(stats_enabled) {
+    if (!active) return;
+    phase_stack.push_back(current_phase);
+    switch_phase(phase);
+}
+
+PhaseTimer::~PhaseTimer() {
+    if (!active) return;
+    stats_phase outer = phase_stack.back();
+    phase_stack.pop_back();
+    switch_phase(outer);
+}
+
+void stats_begin() {
+    stats_enabled = true;
+    start_time = last_switch = stats_clock::now();
+}
+
+void stats_count_token() { token_count++; }
+void stats_count_temp() { temp_count++; }
+
+void stats_count_quad(op_code op) {
+    if ((size_t)op >= opcode_counts.size()) opcode_counts.resize(op + 1, 0);
+    opcode_counts[op]++;
+}
+
+static long peak_rss_kb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+void stats_record_optimized(long quads) {
+    optimized_quads = quads;
+}
+
+void stats_mark_stage(const std::string& stage) {
+    if (stats_enabled) stage_peaks.emplace_back(stage, peak_rss_kb());
+}
+
+static std::string scope_path(SymbolTable* table) {
+    std::string path;
+    for (SymbolTable* t = table; t; t = t->parent) {
+        std::string name = !t->parent ? "global" : (t->scope_name.empty() ? "block" : t->scope_name);
+        path = path.empty() ? name : name + "/" + path;
+    }
+    return path;
+}
+
+void stats_record_scope_tree(SymbolTable* table) {
+    if (!stats_enabled || !table) return;
+    ScopeStats entry = {scope_path(table), table->scope_level, 0, 0};
+    for (const auto& [name, symbol] : table->symbols) {
+        if (!symbol) continue;
+        entry.symbols++;
+        if (symbol->is_temp) entry.temps++;
+    }
+    scope_stats.push_back(entry);
+    for (SymbolTable* child : table->child_scopes) stats_record_scope_tree(child);
+}
+
+static std::string json_string(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+static double per_second(long count, double seconds) {
+    return seconds > 0 ? count / seconds : 0.0;
+}
+
+bool write_stats_report(const std::string& filename, const std::string& input_name) {
+    switch_phase(current_phase); // Charge the time up to now
+    double total = std::chrono::duration<double>(last_switch - start_time).count();
+
+    long quad_count = 0;
+    for (long n : opcode_counts) quad_count += n;
+
+    std::ofstream out(filename);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not open stats output file: " << filename << std::endl;
+        return false;
+    }
+    out << std::fixed << std::setprecision(3);
+    out << "{\n";
+    out << "  \"input\": " << json_string(input_name) << ",\n";
+    out << "  \"wall_time_ms\": {\n";
+    out << "    \"total\": " << total * 1000.0;
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        out << ",\n    " << json_string(PHASE_NAMES[p]) << ": " << phase_seconds[p] * 1000.0;
+    }
+    out << "\n  },\n";
+    out << "  \"tokens\": " << token_count << ",\n";
+    out << "  \"tokens_per_sec\": " << per_second(token_count, total) << ",\n";
+    out << "  \"lexer_tokens_per_sec\": " << per_second(token_count, phase_seconds[PHASE_LEX]) << ",\n";
+    out << "  \"quads\": " << quad_count << ",\n";
+    out << "  \"quads_per_sec\": " << per_second(quad_count, total) << ",\n";
+    if (optimized_quads >= 0) out << "  \"optimized_quads\": " << optimized_quads << ",\n";
+    out << "  \"temps_created\": " << temp_count << ",\n";
+    out << "  \"quads_by_opcode\": {";
+    bool first = true;
+    for (size_t op = 0; op < opcode_counts.size(); ++op) {
+        if (opcode_counts[op] == 0) continue;
+        out << (first ? "\n    " : ",\n    ") << json_string(opcode_to_string((op_code)op)) << ": " << opcode_counts[op];
+        first = false;
+    }
+    out << (first ? "},\n" : "\n  },\n");
+    out << "  \"scopes\": [";
+    for (size_t i = 0; i < scope_stats.size(); ++i) {
+        const ScopeStats& s = scope_stats[i];
+        out << (i ? ",\n    " : "\n    ")
+            << "{\"scope\": " << json_string(s.path) << ", \"level\": " << s.level
+            << ", \"symbols\": " << s.symbols << ", \"temps\": " << s.temps << "}";
+    }
+    out << (scope_stats.empty() ? "],\n" : "\n  ],\n");
+    out << "  \"peak_rss_kb_by_stage\": {";
+    for (size_t i = 0; i < stage_peaks.size(); ++i) {
+        out << (i ? ", " : "") << json_string(stage_peaks[i].first) << ": " << stage_peaks[i].second;
+    }
+    out << "},\n";
+    out << "  \"peak_rss_kb\": " << peak_rss_kb() << "\n";
+    out << "}\n";
+
+    std::cout << "Translation statistics written to " << filename << std::endl;
+    return true;
+}
@@ -0,0 +1,228 @@
+#include "a9_220101003.h"
+#include <iostream>
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
+// --- Tail-call elimination (-O) ---
+// A call whose result is returned straight away,
+//     param a1 ... param an; t = call g, n; return t
+// needs nothing from the caller's frame afterwards. When g is the function
+// itself the call becomes a loop: the arguments are assigned to the
+// parameters, locals that a fresh frame would read as 0 are reset, and control
+// jumps back to the first quad of the body. A tail call to another function
+// becomes OP_TAILCALL, which replaces the caller's frame with the callee's,
+// when the callee's frame fits in the caller's. Either way, recursion in tail
+// position runs in constant stack.
+//
+// Nothing may point into the caller's frame: functions that take the address
+// of a local or parameter, or that have local arrays (which are passed by
+// address), are left alone.
+
+struct TailCallSite {
+    int params;  // First OP_PARAM quad of the call
+    int call;    // The OP_CALL
+    int ret;     // The OP_RETURN (or OP_FUNC_END of a void function) that follows it
+};
+
+static bool reads_result(op_code op) {
+    switch (op) {
+        case OP_PARAM: case OP_RETURN: case OP_DEREF_ASSIGN: case OP_ARRAY_ASSIGN:
+        case OP_BLOCK_FILL: case OP_BLOCK_COPY:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool reads(const Quad& quad, const std::string& name) {
+    return quad.arg1 == name || quad.arg2 == name || (quad.result == name && reads_result(quad.op));
+}
+
+static void collect_frame(SymbolTable* table, std::vector<Symbol*>& symbols) {
+    for (const auto& [name, symbol] : table->symbols) if (symbol) symbols.push_back(symbol);
+    for (SymbolTable* child : table->child_scopes) collect_frame(child, symbols);
+}
+
+// Parameters, locals and temporaries of a function
+static std::vector<Symbol*> frame_symbols(const FunctionRange& fn) {
+    std::vector<Symbol*> symbols;
+    if (SymbolTable* scope = find_function_scope(fn.name)) collect_frame(scope, symbols);
+    Symbol* func_sym = global_symbol_table ? global_symbol_table->lookup(fn.name) : nullptr;
+    if (func_sym) {
+        for (Symbol* param : func_sym->parameters) {
+            if (param && std::find(symbols.begin(), symbols.end(), param) == symbols.end()) symbols.push_back(param);
+        }
+    }
+    return symbols;
+}
+
+static int frame_bytes(const FunctionRange& fn) {
+    int bytes = 0;
+    for (Symbol* symbol : frame_symbols(fn)) bytes += symbol->size;
+    return bytes;
+}
+
+// True if no pointer into the function's frame can exist
+static bool frame_is_private(const FunctionRange& fn) {
+    Symbol* func_sym = global_symbol_table ? global_symbol_table->lookup(fn.name) : nullptr;
+    for (Symbol* symbol : frame_symbols(fn)) {
+        bool is_param = func_sym && std::find(func_sym->parameters.begin(), func_sym->parameters.end(), symbol) != func_sym->parameters.end();
+        if (!is_param && symbol->type && symbol->type->base == TYPE_ARRAY) return false; // Array parameters point elsewhere
+    }
+    for (int i = fn.begin + 1; i < fn.end; ++i) {
+        if (quad_list[i].op == OP_ADDR && local_symbol(fn, quad_list[i].arg1)) return false;
+    }
+    return true;
+}
+
+// Calls in fn whose result (if any) is returned unchanged by the next quad
+static std::vector<TailCallSite> find_tail_calls(const FunctionRange& fn) {
+    std::vector<TailCallSite> sites;
+    std::unordered_set<int> targets; // Quads some jump lands on
+    for (int i = fn.begin + 1; i < fn.end; ++i) {
+        const Quad& quad = quad_list[i];
+        if (is_jump_op(quad.op) && !quad.result.empty()) targets.insert(std::stoi(quad.result) - quad_base);
+    }
+    for (int i = fn.begin + 1; i + 1 <= fn.end; ++i) {
+        const Quad& call = quad_list[i];
+        if (call.op != OP_CALL) continue;
+        const Quad& next = quad_list[i + 1];
+        bool returned = next.op == OP_RETURN && next.result == call.result && next.type_class == call.type_class;
+        bool falls_off = call.result.empty() && next.op == OP_FUNC_END;
+        if (!returned && !falls_off) continue;
+        if (!call.result.empty()) { // The result must have no other reader
+            int readers = 0;
+            for (int j = fn.begin + 1; j < fn.end; ++j) readers += reads(quad_list[j], call.result);
+            if (readers != 1) continue;
+        }
+        int count = call.arg2.empty() ? 0 : std::stoi(call.arg2);
+        int first = i - count;
+        bool contiguous = first > fn.begin;
+        for (int j = first; contiguous && j < i; ++j) contiguous = quad_list[j].op == OP_PARAM;
+        if (!contiguous) continue;
+        bool entered_midway = false; // Only the first PARAM may be a jump target
+        for (int j = first + 1; j <= i + (returned ? 1 : 0); ++j) entered_midway |= targets.count(j) > 0;
+        if (entered_midway) continue;
+        sites.push_back({first, i, i + 1});
+    }
+    return sites;
+}
+
+// Locals a fresh activation would read as 0 before storing to them: read somewhere in
+// the function, and not certainly written first in the straight-line code at its entry
+static std::vector<Symbol*> locals_to_reset(const FunctionRange& fn, const FunctionCFG& cfg) {
+    std::vector<Symbol*> reset;
+    Symbol* func_sym = global_symbol_table ? global_symbol_table->lookup(fn.name) : nullptr;
+    std::unordered_set<std::string> params;
+    if (func_sym) for (Symbol* param : func_sym->parameters) if (param) params.insert(param->name);
+    std::unordered_set<std::string> seen;
+    for (Symbol* symbol : frame_symbols(fn)) {
+        if (symbol->is_temp || params.count(symbol->name) || !seen.insert(symbol->name).second) continue;
+        bool read = false;
+        for (int i = fn.begin + 1; i < fn.end && !read; ++i) read = reads(quad_list[i], symbol->name);
+        if (!read) continue;
+        bool written_first = false;
+        for (int i = cfg.blocks[0].begin; i < cfg.blocks[0].end; ++i) {
+            const Quad& quad = quad_list[i];
+            if (reads(quad, symbol->name)) break;
+            if (quad.result == symbol->name && !is_jump_op(quad.op)) { written_first = true; break; }
+        }
+        if (!written_first) reset.push_back(symbol);
+    }
+    return reset;
+}
+
+// A temporary in fn's scope that holds a copy of an argument across the parameter assignments
+static std::string argument_copy(const FunctionRange& fn, const Symbol* param) {
+    SymbolTable* saved = current_symbol_table;
+    if (SymbolTable* scope = find_function_scope(fn.name)) current_symbol_table = scope;
+    Symbol* temp = new_temp(new TypeInfo(*param->type));
+    current_symbol_table = saved;
+    return temp->name;
+}
+
+void eliminate_tail_calls() {
+    std::vector<FunctionRange> functions = find_functions();
+    std::map<std::string, const FunctionRange*> by_name;
+    for (const FunctionRange& fn : functions) by_name[fn.name] = &fn;
+
+    std::vector<bool> removed(quad_list.size(), false);
+    std::map<int, std::vector<Quad>> insert_before;
+    int loops = 0, jumps = 0;
+    for (const FunctionRange& fn : functions) {
+        std::vector<TailCallSite> sites = find_tail_calls(fn);
+        if (sites.empty()) continue;
+        if (!frame_is_private(fn)) {
+            std::map<std::string, int> kept;
+            for (const TailCallSite& site : sites) {
+                const std::string& callee = quad_list[site.call].arg1;
+                opt_report("tailcall", "'" + fn.name + "': call " + std::to_string(++kept[callee]) + " to '" + callee +
+                           "' kept (the frame has a local array or an address-taken local)");
+            }
+            continue;
+        }
+        Symbol* func_sym = global_symbol_table ? global_symbol_table->lookup(fn.name) : nullptr;
+        FunctionCFG cfg = build_cfg(fn);
+        if (cfg.blocks.empty()) continue;
+        std::vector<Symbol*> reset = locals_to_reset(fn, cfg);
+        std::map<std::string, int> ordinal; // Per callee, for the report
+
+        for (const TailCallSite& site : sites) {
+            const Quad& call = quad_list[site.call];
+            std::string number = std::to_string(++ordinal[call.arg1]);
+            auto callee = by_name.find(call.arg1);
+            if (callee == by_name.end()) continue; // Not defined here
+
+            if (call.arg1 == fn.name) {
+                // Self call: parameters <- arguments, then back to the entry
+                if (!func_sym || (int)func_sym->parameters.size() != site.call - site.params) continue;
+                std::vector<Quad> rewrite;
+                std::vector<std::string> args;
+                for (int j = site.params; j < site.call; ++j) args.push_back(quad_list[j].result);
+                const std::vector<Symbol*>& formals = func_sym->parameters;
+                for (size_t k = 0; k < args.size(); ++k) { // An argument naming an already assigned parameter is copied first
+                    bool clobbered = false;
+                    for (size_t j = 0; j < k; ++j) clobbered |= formals[j] && args[k] == formals[j]->name && args[j] != formals[j]->name;
+                    if (!clobbered) continue;
+                    std::string copy = argument_copy(fn, formals[k]);
+                    rewrite.emplace_back(OP_ASSIGN, copy, args[k], "", quad_list[site.params + k].type_class);
+                    args[k] = copy;
+                }
+                for (size_t k = 0; k < args.size(); ++k) {
+                    if (!formals[k] || args[k] == formals[k]->name) continue;
+                    rewrite.emplace_back(OP_ASSIGN, formals[k]->name, args[k], "", quad_list[site.params + k].type_class);
+                }
+                for (Symbol* local : reset) rewrite.emplace_back(OP_ASSIGN, local->name, "0", "", class_of(local->type));
+                rewrite.emplace_back(OP_GOTO, std::to_string(quad_base + fn.begin + 1));
+                for (int j = site.params; j <= site.call; ++j) removed[j] = true;
+                if (quad_list[site.ret].op == OP_RETURN) removed[site.ret] = true;
+                insert_before[site.params] = rewrite;
+                opt_report("tailcall", "'" + fn.name + "': self call " + number + " in tail position -> " +
+                           std::to_string(args.size()) + " parameter assignment(s), " + std::to_string(reset.size()) +
+                           " local reset(s) and a jump to the entry");
+                loops++;
+                continue;
+            }
+
+            // Call to another function: reuse this frame if the callee's fits in it
+            int caller_bytes = frame_bytes(fn), callee_bytes = frame_bytes(*callee->second);
+            if (callee_bytes > caller_bytes) {
+                opt_report("tailcall", "'" + fn.name + "': call " + number + " to '" + call.arg1 + "' kept (frame " +
+                           std::to_string(callee_bytes) + " > " + std::to_string(caller_bytes) + " bytes)");
+                continue;
+            }
+            removed[site.call] = true;
+            if (quad_list[site.ret].op == OP_RETURN) removed[site.ret] = true;
+            insert_before[site.call] = {Quad(OP_TAILCALL, "", call.arg1, call.arg2, call.type_class)};
+            opt_report("tailcall", "'" + fn.name + "': call " + number + " to '" + call.arg1 + "' -> tailcall (frame " +
+                       std::to_string(callee_bytes) + " <= " + std::to_string(caller_bytes) + " bytes)");
+            jumps++;
+        }
+    }
+    if (loops == 0 && jumps == 0) return;
+    rewrite_quads(removed, insert_before, {});
+    opt_report("tailcall", "total: " + std::to_string(loops) + " self call(s) turned into loops, " +
+               std::to_string(jumps) + " tail call(s) reusing the caller's frame");
+}
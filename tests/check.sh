@@ -0,0 +1,163 @@
+#!/bin/sh
+# Regression harness behind `make check`. For every tests/*.mc it
+#   1. translates the file and compares .lex.out, .tac and .quad with the
+#      checked-in goldens in output/;
+#   2. when OPT is set, translates it again with those flags, executes both
+#      results on the TAC interpreter (--run) and requires identical results;
+#   3. translates it twice more through a fresh --cache-dir (with OPT and --run)
+#      and requires the second, cache-hitting run to produce the same .tac,
+#      .quad, .run and .report as a translation without the cache;
+#   4. records the quad count (after optimisation, if OPT ran any) and fails if
+#      it grew past its threshold relative to the baseline file;
+#   5. records translation time (fastest of RUNS, from --stats). Times are only
+#      compared when REF_BIN names a reference translator: it is timed on the
+#      same machine in the same run, and the check fails if this build is slower
+#      than it by more than the threshold. Absolute times differ too much between
+#      hosts to be kept in the baseline.
+# Runs in a scratch directory so the checked-in output/ files are not touched.
+#
+# Usage: tests/check.sh
+#   OPT="-O"             translator flags to check for semantic equivalence
+#   BASELINE=<file>      quad count baseline (default: tests/perf_baseline.csv)
+#   QUAD_THRESHOLD=<n>   allowed quad count growth in percent (default: 0)
+#   REF_BIN=<path>       reference translator to time against (e.g. a build of the parent commit)
+#   TIME_THRESHOLD=<n>   allowed slowdown against REF_BIN in percent (default: 100)
+#   TIME_SLACK_MS=<n>    absolute time allowance on top of that (default: 2)
+#   RUNS=<n>             timing runs per test (default: 5)
+#   UPDATE_BASELINE=1    rewrite the baseline from this run instead of checking
+#   BIN=<path>           translator to test (default: ./microC_translator)
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+BIN=${BIN:-$ROOT/microC_translator}
+BASELINE=${BASELINE:-$ROOT/tests/perf_baseline.csv}
+QUAD_THRESHOLD=${QUAD_THRESHOLD:-0}
+TIME_THRESHOLD=${TIME_THRESHOLD:-100}
+TIME_SLACK_MS=${TIME_SLACK_MS:-2}
+RUNS=${RUNS:-5}
+
+case "$BIN" in /*) ;; *) BIN="$(pwd)/$BIN" ;; esac
+case "$BASELINE" in /*) ;; *) BASELINE="$(pwd)/$BASELINE" ;; esac
+case "$REF_BIN" in ""|/*) ;; *) REF_BIN="$(pwd)/$REF_BIN" ;; esac
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+failures=0
+results="$WORK/results.csv"
+echo "test,flags,quads" > "$results"
+
+fail() { echo "  FAIL: $*"; failures=$((failures + 1)); }
+
+# Value of a "key": number line in a stats report
+field() { sed -n "s/^ *\"$2\": \([0-9.]*\),\{0,1\}\$/\1/p" "$1" | head -n 1; }
+
+# Translates $2 in a fresh directory $1 with the remaining arguments as flags (TRANSLATOR overrides BIN)
+translate() {
+    dir=$1; input=$2; shift 2
+    rm -rf "$dir" && mkdir -p "$dir/output"
+    (cd "$dir" && "${TRANSLATOR:-$BIN}" "$@" "$input" > translator.log 2>&1)
+}
+
+# Sets quads and ms from a --stats translation of $1 with flags $2 by $3
+timed_translation() {
+    TRANSLATOR=$3
+    translate "$WORK/perf" "$1" --stats $2 || { TRANSLATOR=; return 1; }
+    TRANSLATOR=
+    report="$WORK/perf/output/$(basename "$1").stats.json"
+    ms=$(field "$report" total)
+    quads=$(field "$report" optimized_quads)
+    [ -n "$quads" ] || quads=$(field "$report" quads)
+}
+
+# Fastest of RUNS timed translations, alternating with REF_BIN if set so both see
+# the same machine load; appends "test,flags,quads" to the results
+measure() {
+    input=$1; flags=$2
+    best=""; ref_best=""
+    i=0
+    while [ $i -lt "$RUNS" ]; do
+        timed_translation "$input" "$flags" "$BIN" || return 1
+        best=$(awk -v a="$best" -v b="$ms" 'BEGIN { print (a == "" || b < a) ? b : a }')
+        new_quads=$quads
+        if [ -n "$REF_BIN" ]; then
+            timed_translation "$input" "$flags" "$REF_BIN" || return 1
+            ref_best=$(awk -v a="$ref_best" -v b="$ms" 'BEGIN { print (a == "" || b < a) ? b : a }')
+        fi
+        i=$((i + 1))
+    done
+    echo "$(basename "$input"),${flags:--},$new_quads" >> "$results"
+    if [ -z "$REF_BIN" ]; then
+        echo "  $new_quads quads, ${best} ms (${flags:-no flags})"
+        return 0
+    fi
+    echo "  $new_quads quads, ${best} ms, reference ${ref_best} ms (${flags:-no flags})"
+    slow=$(awk -v t="$best" -v r="$ref_best" -v tt="$TIME_THRESHOLD" -v slack="$TIME_SLACK_MS" \
+        'BEGIN { if (t > r * (100 + tt) / 100 + slack) print "yes" }')
+    [ -z "$slow" ] || fail "$(basename "$input") (${flags:--}): ${best} ms, reference ${ref_best} ms (+${TIME_THRESHOLD}% +${TIME_SLACK_MS} ms allowed)"
+}
+
+for input in "$ROOT"/tests/*.mc; do
+    name=$(basename "$input")
+    echo "$name"
+
+    # 1. Golden outputs
+    if translate "$WORK/plain" "$input"; then
+        for ext in lex.out tac quad; do
+            golden="$ROOT/output/$name.$ext"
+            if [ ! -f "$golden" ]; then echo "  (no golden $name.$ext)"; continue; fi
+            cmp -s "$WORK/plain/output/$name.$ext" "$golden" || fail "$name.$ext differs from output/$name.$ext"
+        done
+    else
+        fail "translation failed (see below)"; cat "$WORK/plain/translator.log"
+        continue
+    fi
+
+    # 2. Semantic equivalence of the optimised TAC
+    if [ -n "$OPT" ]; then
+        translate "$WORK/old" "$input" --run && translate "$WORK/new" "$input" $OPT --run || fail "translation with --run failed"
+        if ! cmp -s "$WORK/old/output/$name.run" "$WORK/new/output/$name.run"; then
+            fail "results differ with $OPT"
+            diff "$WORK/old/output/$name.run" "$WORK/new/output/$name.run" | sed 's/^/    /'
+        fi
+    fi
+
+    # 3. A translation served from the cache matches a clean one
+    rm -rf "$WORK/cache"
+    if translate "$WORK/clean" "$input" $OPT --run && translate "$WORK/cold" "$input" --cache-dir "$WORK/cache" $OPT --run &&
+       translate "$WORK/warm" "$input" --cache-dir "$WORK/cache" $OPT --run; then
+        grep -q "^Cache: [1-9]" "$WORK/warm/translator.log" || fail "no cache hits on the second cached translation"
+        for ext in tac quad run report; do
+            [ -f "$WORK/clean/output/$name.$ext" ] || continue
+            cmp -s "$WORK/clean/output/$name.$ext" "$WORK/warm/output/$name.$ext" || fail "$name.$ext differs when taken from the cache"
+        done
+    else
+        fail "cached translation failed"
+    fi
+
+    # 4./5. Quad count and translation time
+    measure "$input" "" || fail "timing run failed"
+    [ -n "$OPT" ] && { measure "$input" "$OPT" || fail "timing run with $OPT failed"; }
+done
+
+if [ "$UPDATE_BASELINE" = 1 ]; then
+    cp "$results" "$BASELINE"
+    echo "Baseline written to $BASELINE"
+elif [ -f "$BASELINE" ]; then
+    regressions=$(awk -F, -v qt="$QUAD_THRESHOLD" '
+        NR == FNR { if (FNR > 1) bq[$1 "," $2] = $3; next }
+        FNR > 1 && ($1 "," $2) in bq {
+            if ($3 > bq[$1 "," $2] * (100 + qt) / 100)
+                printf "  FAIL: %s (%s): %d quads, baseline %d (+%s%% allowed)\n", $1, $2, $3, bq[$1 "," $2], qt
+        }' "$BASELINE" "$results")
+    if [ -n "$regressions" ]; then
+        echo "Quad count regressions against $(basename "$BASELINE"):"
+        echo "$regressions"
+        failures=$((failures + $(echo "$regressions" | wc -l)))
+    fi
+else
+    echo "No baseline at $BASELINE; run with UPDATE_BASELINE=1 to create one"
+fi
+
+if [ $failures -ne 0 ]; then
+    echo "check: $failures failure(s)"
+    exit 1
+fi
+echo "check: all tests passed"